@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include "case_conversion.hpp"
+#include "document.hpp"
+
+namespace
+{
+    std::string make_text(int64_t size)
+    {
+        const std::string sentence = "The quick brown fox jumps over the lazy dog. ";
+
+        std::string text;
+        text.reserve(size);
+        while (static_cast<int64_t>(text.size()) < size)
+            text.append(sentence, 0, std::min<size_t>(sentence.size(), size - text.size()));
+
+        return text;
+    }
+
+    void text_sizes(benchmark::internal::Benchmark* bm)
+    {
+        for (int64_t size : {4 << 10, 1 << 20, 16 << 20})
+            bm->Arg(size);
+    }
+}
+
+// implementation used by Document::to_upper before CaseConversion
+static void BM_TransformToUpper(benchmark::State& state)
+{
+    std::string text = make_text(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](auto c) { return std::toupper(c); });
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TransformToUpper)->Apply(text_sizes);
+
+static void BM_CaseConversionToUpper(benchmark::State& state)
+{
+    std::string text = make_text(state.range(0));
+    state.SetLabel(CaseConversion::kernel_name());
+
+    for (auto _ : state)
+    {
+        CaseConversion::to_upper(text.data(), text.size());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CaseConversionToUpper)->Apply(text_sizes);
+
+static void BM_Document_ToUpper(benchmark::State& state)
+{
+    Document doc{make_text(state.range(0))};
+
+    for (auto _ : state)
+    {
+        doc.to_upper();
+        doc.to_lower();
+    }
+
+    state.SetBytesProcessed(2 * state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Document_ToUpper)->Apply(text_sizes);
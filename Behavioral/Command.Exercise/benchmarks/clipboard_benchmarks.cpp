@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <mutex>
+#include <string>
+
+#include "clipboard.hpp"
+
+namespace
+{
+    // previous implementation of SharedClipboard - kept as a baseline
+    class MutexClipboard : public Clipboard
+    {
+        std::string content_;
+        mutable std::mutex content_mtx_;
+
+    public:
+        std::string content() const override
+        {
+            std::lock_guard<std::mutex> lk{content_mtx_};
+
+            return content_;
+        }
+
+        void set_content(const std::string& content) override
+        {
+            std::lock_guard<std::mutex> lk{content_mtx_};
+
+            content_ = content;
+        }
+    };
+
+    const std::string clipboard_text(4096, 'x');
+
+    // thread 0 also replaces the content every 64 reads
+    template <typename TClipboard, typename TRead>
+    void read_mostly(benchmark::State& state, TClipboard& clipboard, TRead read)
+    {
+        if (state.thread_index() == 0)
+            clipboard.set_content(clipboard_text);
+
+        size_t reads = 0;
+        for (auto _ : state)
+        {
+            read(clipboard);
+
+            if (state.thread_index() == 0 && ++reads % 64 == 0)
+                clipboard.set_content(clipboard_text);
+        }
+
+        state.SetItemsProcessed(state.iterations());
+    }
+}
+
+static void BM_MutexClipboard_Content(benchmark::State& state)
+{
+    static MutexClipboard clipboard;
+
+    read_mostly(state, clipboard, [](const Clipboard& c) {
+        auto text = c.content();
+        benchmark::DoNotOptimize(text);
+    });
+}
+BENCHMARK(BM_MutexClipboard_Content)->ThreadRange(1, 64)->UseRealTime();
+
+static void BM_SharedClipboard_Snapshot(benchmark::State& state)
+{
+    static SharedClipboard clipboard;
+
+    read_mostly(state, clipboard, [](const Clipboard& c) {
+        auto snapshot = c.snapshot();
+        benchmark::DoNotOptimize(snapshot);
+    });
+}
+BENCHMARK(BM_SharedClipboard_Snapshot)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,241 @@
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "application.hpp"
+#include "command.hpp"
+#include "memory_counters.hpp"
+
+namespace
+{
+    constexpr int64_t KB = 1 << 10;
+    constexpr int64_t MB = 1 << 20;
+
+    // mixed-case words - every command has something to change
+    std::string make_text(int64_t size)
+    {
+        const std::string words = "The quick brown fox jumps over the lazy dog. ";
+
+        std::string text;
+        text.reserve(size);
+        while (static_cast<int64_t>(text.size()) < size)
+            text.append(words, 0, std::min<size_t>(words.size(), size - text.size()));
+
+        return text;
+    }
+
+    // answers prompts of commands with given lines (repeated), output is discarded
+    class BenchmarkConsole : public Console
+    {
+        std::vector<std::string> lines_;
+        size_t next_{};
+
+    public:
+        explicit BenchmarkConsole(std::vector<std::string> lines = {""})
+            : lines_{std::move(lines)}
+        {
+        }
+
+        std::string get_line() override
+        {
+            return lines_[next_++ % lines_.size()];
+        }
+
+        void print(const std::string&) override
+        {
+        }
+    };
+
+    struct Editor
+    {
+        Document doc;
+        BenchmarkConsole console;
+        SharedClipboard clipboard;
+        CommandHistory history;
+        UndoCmd undo{console, history};
+        RedoCmd redo{console, history};
+
+        Editor(int64_t doc_size, std::vector<std::string> console_lines)
+            : doc{make_text(doc_size)}
+            , console{std::move(console_lines)}
+        {
+            clipboard.set_content("pasted text");
+        }
+    };
+
+    using CommandFactory = std::function<ReversibleCommandPtr(Editor&)>;
+
+    void doc_sizes(benchmark::internal::Benchmark* bench)
+    {
+        bench->ArgName("doc_size")->Arg(KB)->Arg(64 * KB)->Arg(MB);
+    }
+}
+
+// edit & undo latency of each reversible command - the document is restored by every iteration
+static void BM_Command_ExecuteUndo(benchmark::State& state, std::vector<std::string> console_lines, CommandFactory factory)
+{
+    Editor editor{state.range(0), console_lines};
+    auto cmd = factory(editor);
+
+    const auto start = MemoryCounters::current();
+    for (auto _ : state)
+    {
+        cmd->execute();
+        editor.undo.execute();
+    }
+    MemoryCounters::report(state, MemoryCounters::since(start));
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_CAPTURE(BM_Command_ExecuteUndo, Clear, std::vector<std::string>{}, [](Editor& e) -> ReversibleCommandPtr {
+    return std::make_unique<ClearCmd>(e.doc, e.history);
+})->Apply(doc_sizes);
+BENCHMARK_CAPTURE(BM_Command_ExecuteUndo, ToUpper, std::vector<std::string>{}, [](Editor& e) -> ReversibleCommandPtr {
+    return std::make_unique<ToUpperCmd>(e.doc, e.history);
+})->Apply(doc_sizes);
+BENCHMARK_CAPTURE(BM_Command_ExecuteUndo, AddText, std::vector<std::string>{"typed text"}, [](Editor& e) -> ReversibleCommandPtr {
+    return std::make_unique<AddTextCmd>(e.doc, e.console, e.history);
+})->Apply(doc_sizes);
+BENCHMARK_CAPTURE(BM_Command_ExecuteUndo, Paste, std::vector<std::string>{}, [](Editor& e) -> ReversibleCommandPtr {
+    return std::make_unique<PasteCmd>(e.doc, e.clipboard, e.history);
+})->Apply(doc_sizes);
+BENCHMARK_CAPTURE(BM_Command_ExecuteUndo, FindReplace, std::vector<std::string>{"fox", "cat"}, [](Editor& e) -> ReversibleCommandPtr {
+    return std::make_unique<FindReplaceCmd>(e.doc, e.console, e.history);
+})->Apply(doc_sizes);
+
+// undo & redo through a deep history - args: document size, history depth
+static void BM_CommandHistory_UndoRedo(benchmark::State& state)
+{
+    const int64_t depth = state.range(1);
+    Editor editor{state.range(0), {"typed text"}};
+    AddTextCmd add_text{editor.doc, editor.console, editor.history};
+    ToUpperCmd to_upper{editor.doc, editor.history};
+
+    for (int64_t i = 0; i < depth; ++i)
+    {
+        if (i % 2 == 0)
+            add_text.execute();
+        else
+            to_upper.execute();
+    }
+
+    const auto start = MemoryCounters::current();
+    for (auto _ : state)
+    {
+        for (int64_t i = 0; i < depth; ++i)
+            editor.undo.execute();
+        for (int64_t i = 0; i < depth; ++i)
+            editor.redo.execute();
+    }
+    MemoryCounters::report(state, MemoryCounters::since(start));
+
+    state.SetItemsProcessed(state.iterations() * depth * 2);
+}
+BENCHMARK(BM_CommandHistory_UndoRedo)
+    ->ArgNames({"doc_size", "depth"})
+    ->ArgsProduct({{KB, MB}, {16, 256, 4096}})
+    ->Unit(benchmark::kMicrosecond);
+
+namespace
+{
+    enum CommandMix
+    {
+        typing, // AddText only
+        editing, // all commands
+        undo_redo // short edits undone and redone
+    };
+
+    // script of a batch run with count commands (lines read by commands are not counted)
+    std::string make_script(CommandMix mix, int64_t count)
+    {
+        std::vector<std::vector<std::string>> steps;
+        switch (mix)
+        {
+        case typing:
+            steps = {{"AddText", "typed text"}};
+            break;
+        case editing:
+            steps = {{"AddText", "The Fox"}, {"ToUpper"}, {"Paste"}, {"FindReplace", "FOX", "cat"}, {"Undo"}, {"Redo"}, {"Print"}, {"Clear"}, {"Undo"}};
+            break;
+        case undo_redo:
+            steps = {{"AddText", "a"}, {"AddText", "b"}, {"Undo"}, {"Undo"}, {"Redo"}, {"Redo"}};
+            break;
+        }
+
+        std::string script;
+        for (int64_t i = 0; i < count; ++i)
+        {
+            for (const auto& line : steps[i % steps.size()])
+                script += line + '\n';
+        }
+
+        return script;
+    }
+
+    // editor driven by a script as in main() - commands read their input from the script
+    struct BatchEditor
+    {
+        std::istringstream script;
+        ScriptConsole console;
+        Document doc;
+        SharedClipboard clipboard;
+        CommandHistory history;
+        Application app{console};
+
+        BatchEditor(const std::string& script_text, const std::string& text, std::ostream& output)
+            : script{script_text}
+            , console{script, output}
+            , doc{text}
+        {
+            clipboard.set_content("pasted text");
+
+            app.add_command("Print", std::make_shared<PrintCmd>(doc, console));
+            app.add_command("ToUpper", std::make_shared<ToUpperCmd>(doc, history));
+            app.add_command("Clear", std::make_shared<ClearCmd>(doc, history));
+            app.add_command("AddText", std::make_shared<AddTextCmd>(doc, console, history));
+            app.add_command("Paste", std::make_shared<PasteCmd>(doc, clipboard, history));
+            app.add_command("FindReplace", std::make_shared<FindReplaceCmd>(doc, console, history));
+            app.add_command("Undo", std::make_shared<UndoCmd>(console, history));
+            app.add_command("Redo", std::make_shared<RedoCmd>(console, history));
+        }
+    };
+}
+
+// Application dispatch of a whole script - args: command mix, document size
+static void BM_Application_RunBatch(benchmark::State& state)
+{
+    constexpr int64_t command_count = 1000;
+    const std::string script_text = make_script(static_cast<CommandMix>(state.range(0)), command_count);
+    const std::string text = make_text(state.range(1));
+    std::ofstream null_output{"/dev/null"};
+
+    MemoryCounters::Snapshot allocated;
+    for (auto _ : state)
+    {
+        // set-up and teardown of an editor are not measured
+        state.PauseTiming();
+        auto editor = std::make_unique<BatchEditor>(script_text, text, null_output);
+        const auto start = MemoryCounters::current(); // reads RSS - kept out of the timed part
+        state.ResumeTiming();
+
+        auto stats = editor->app.run_batch(editor->script);
+        benchmark::DoNotOptimize(stats);
+
+        state.PauseTiming();
+        allocated += MemoryCounters::since(start);
+        editor.reset();
+        state.ResumeTiming();
+    }
+    MemoryCounters::report(state, allocated);
+
+    state.SetItemsProcessed(state.iterations() * command_count);
+}
+BENCHMARK(BM_Application_RunBatch)
+    ->ArgNames({"mix", "doc_size"})
+    ->ArgsProduct({{typing, editing, undo_redo}, {KB, 64 * KB}})
+    ->Unit(benchmark::kMillisecond);
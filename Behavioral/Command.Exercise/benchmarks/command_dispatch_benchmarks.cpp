@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cctype>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "command_registry.hpp"
+
+namespace
+{
+    struct NoopCommand : Command
+    {
+        void execute() override
+        { }
+    };
+
+    const std::vector<std::string> command_names = {"Print", "ToUpper", "ToLower", "Clear", "AddText", "Paste", "Copy", "Undo", "Redo"};
+
+    // lines as typed by a user - mixed case
+    const std::vector<std::string> input_lines = {"print", "TOUPPER", "toLower", "Clear", "addtext", "PASTE", "copy", "undo", "Redo", "unknown"};
+
+    void to_upper(std::string& text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](auto c) { return std::toupper(c); });
+    }
+}
+
+// dispatch as done by Application before CommandRegistry: copy + upper-case + hash map lookup
+static void BM_UnorderedMapDispatch(benchmark::State& state)
+{
+    std::unordered_map<std::string, CommandSharedPtr> cmds;
+    for (auto name : command_names)
+    {
+        to_upper(name);
+        cmds.emplace(std::move(name), std::make_shared<NoopCommand>());
+    }
+
+    for (auto _ : state)
+    {
+        for (const auto& line : input_lines)
+        {
+            auto name = line;
+            to_upper(name);
+            auto pos = cmds.find(name);
+            benchmark::DoNotOptimize(pos);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * input_lines.size());
+}
+BENCHMARK(BM_UnorderedMapDispatch);
+
+static void BM_CommandRegistryDispatch(benchmark::State& state)
+{
+    CommandRegistry cmds;
+    for (const auto& name : command_names)
+        cmds.add(name, std::make_shared<NoopCommand>());
+
+    for (auto _ : state)
+    {
+        for (const auto& line : input_lines)
+        {
+            Command* cmd = cmds.find(line);
+            benchmark::DoNotOptimize(cmd);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * input_lines.size());
+}
+BENCHMARK(BM_CommandRegistryDispatch);
@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "buffered_console.hpp"
+
+namespace
+{
+    const std::string line = "Unknown command: FINDREPLACE";
+}
+
+// one write and flush per line - as Terminal does with std::endl
+static void BM_Console_PrintFlushingEachLine(benchmark::State& state)
+{
+    std::ofstream out{"/dev/null"};
+
+    for (auto _ : state)
+        out << line << std::endl;
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Console_PrintFlushingEachLine);
+
+static void BM_Console_PrintBuffered(benchmark::State& state)
+{
+    const int fd = ::open("/dev/null", O_WRONLY);
+    {
+        BufferedConsoleOptions options;
+        options.output_thread = state.range(0) != 0;
+        BufferedConsole console{0, fd, options};
+
+        for (auto _ : state)
+            console.print(line);
+    }
+    ::close(fd);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Console_PrintBuffered)->ArgName("output_thread")->Arg(0)->Arg(1);
@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include "document.hpp"
+
+namespace
+{
+    constexpr int64_t KB = 1 << 10;
+    constexpr int64_t MB = 1 << 20;
+    constexpr int64_t GB = 1 << 30;
+
+    template <typename Storage>
+    Document make_document(int64_t size)
+    {
+        return Document{std::make_unique<Storage>(std::string(size, 'a'))};
+    }
+}
+
+// edit latency - insert & erase of a short text in the middle of a document
+template <typename Storage>
+static void BM_Document_EditInTheMiddle(benchmark::State& state)
+{
+    auto doc = make_document<Storage>(state.range(0));
+    const std::string text = "0123456789abcdef";
+    const size_t middle = doc.length() / 2;
+
+    for (auto _ : state)
+    {
+        doc.replace(middle, 0, text);
+        doc.replace(middle, text.size(), "");
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK_TEMPLATE(BM_Document_EditInTheMiddle, StringStorage)->Arg(KB)->Arg(MB)->Arg(GB)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_Document_EditInTheMiddle, PieceTableStorage)->Arg(KB)->Arg(MB)->Arg(GB)->Unit(benchmark::kNanosecond);
+
+template <typename Storage>
+static void BM_Document_EditAtTheBeginning(benchmark::State& state)
+{
+    auto doc = make_document<Storage>(state.range(0));
+    const std::string text = "0123456789abcdef";
+
+    for (auto _ : state)
+    {
+        doc.replace(0, 0, text);
+        doc.replace(0, text.size(), "");
+    }
+
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK_TEMPLATE(BM_Document_EditAtTheBeginning, StringStorage)->Arg(KB)->Arg(MB)->Arg(GB)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_Document_EditAtTheBeginning, PieceTableStorage)->Arg(KB)->Arg(MB)->Arg(GB)->Unit(benchmark::kNanosecond);
+
+template <typename Storage>
+static void BM_Document_AddText(benchmark::State& state)
+{
+    auto doc = make_document<Storage>(state.range(0));
+    const std::string text = "x";
+
+    for (auto _ : state)
+    {
+        doc.add_text(text);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_Document_AddText, StringStorage)->Arg(KB)->Arg(MB)->Arg(GB)->Unit(benchmark::kNanosecond);
+BENCHMARK_TEMPLATE(BM_Document_AddText, PieceTableStorage)->Arg(KB)->Arg(MB)->Arg(GB)->Unit(benchmark::kNanosecond);
+
+// readers - full copy vs. chunk view
+template <typename Storage>
+static void BM_Document_Text(benchmark::State& state)
+{
+    auto doc = make_document<Storage>(state.range(0));
+
+    for (auto _ : state)
+    {
+        auto text = doc.text();
+        benchmark::DoNotOptimize(text.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Document_Text, StringStorage)->Arg(KB)->Arg(MB)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Document_Text, PieceTableStorage)->Arg(KB)->Arg(MB)->Unit(benchmark::kMicrosecond);
+
+template <typename Storage>
+static void BM_Document_ForEachChunk(benchmark::State& state)
+{
+    auto doc = make_document<Storage>(state.range(0));
+
+    for (auto _ : state)
+    {
+        size_t length = 0;
+        doc.for_each_chunk([&length](std::string_view chunk) { length += chunk.size(); });
+        benchmark::DoNotOptimize(length);
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Document_ForEachChunk, StringStorage)->Arg(KB)->Arg(MB)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Document_ForEachChunk, PieceTableStorage)->Arg(KB)->Arg(MB)->Unit(benchmark::kMicrosecond);
+
+// text with a word to replace every 1 KB
+template <typename Storage>
+static void BM_Document_ReplaceAll(benchmark::State& state)
+{
+    std::string text(state.range(0), 'a');
+    for (size_t pos = 0; pos + 6 < text.size(); pos += KB)
+        text.replace(pos, 6, "needle");
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        Document doc{std::make_unique<Storage>(text)};
+        state.ResumeTiming();
+
+        benchmark::DoNotOptimize(doc.replace_all("needle", "pin"));
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_Document_ReplaceAll, StringStorage)->Arg(KB)->Arg(MB)->Arg(64 * MB)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_Document_ReplaceAll, PieceTableStorage)->Arg(KB)->Arg(MB)->Arg(64 * MB)->Unit(benchmark::kMicrosecond);
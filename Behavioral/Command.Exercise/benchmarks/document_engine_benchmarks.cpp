@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "document_engine.hpp"
+
+namespace
+{
+    constexpr size_t document_count = 256;
+    constexpr size_t document_size = 16 << 10;
+    constexpr size_t commands_per_document = 16;
+
+    void thread_counts(benchmark::internal::Benchmark* bm)
+    {
+        const int max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+        for (int threads = 1; threads < max_threads; threads *= 2)
+            bm->Arg(threads);
+        bm->Arg(max_threads);
+    }
+}
+
+// throughput of ToUpper commands spread over many documents
+static void BM_DocumentEngine_Scaling(benchmark::State& state)
+{
+    DocumentEngine engine{static_cast<size_t>(state.range(0)), 64 << 10};
+
+    for (size_t i = 0; i < document_count; ++i)
+        engine.add_document(std::string(document_size, 'a'));
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < commands_per_document; ++i)
+            for (size_t id = 0; id < document_count; ++id)
+                engine.submit(id, std::make_unique<ToUpperCmd>(engine.document(id), engine.history(id)));
+
+        engine.wait();
+    }
+
+    state.SetItemsProcessed(state.iterations() * document_count * commands_per_document);
+    state.SetBytesProcessed(state.iterations() * document_count * commands_per_document * document_size);
+}
+BENCHMARK(BM_DocumentEngine_Scaling)->Apply(thread_counts)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <string>
+
+#include "journal.hpp"
+
+namespace
+{
+    const std::string journal_path = "journal_benchmark.bin";
+
+    constexpr int64_t KB = 1 << 10;
+    constexpr int64_t MB = 1 << 20;
+}
+
+// append latency of journaled edits - fsyncs are batched by group commit
+static void BM_Journal_AppendText(benchmark::State& state)
+{
+    std::remove(journal_path.c_str());
+    const std::string text(state.range(0), 'a');
+
+    {
+        JournalOptions options;
+        options.snapshot_interval_bytes = SIZE_MAX;
+
+        CommandJournal journal{journal_path, options};
+        Document doc{journal.recover()};
+
+        for (auto _ : state)
+            doc.add_text(text);
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    std::remove(journal_path.c_str());
+}
+BENCHMARK(BM_Journal_AppendText)->Arg(64)->Arg(KB)->Arg(64 * KB);
+
+// recovery throughput over a journal of 1 KB appends
+static void BM_Journal_Replay(benchmark::State& state)
+{
+    std::remove(journal_path.c_str());
+    {
+        JournalOptions options;
+        options.snapshot_interval_bytes = SIZE_MAX;
+
+        CommandJournal journal{journal_path, options};
+        Document doc{journal.recover()};
+
+        const std::string text(KB, 'a');
+        for (int64_t i = 0; i < state.range(0) / KB; ++i)
+            doc.add_text(text);
+    }
+
+    for (auto _ : state)
+    {
+        StringStorage storage;
+        CommandJournal::replay(journal_path, storage);
+        benchmark::DoNotOptimize(storage.length());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    std::remove(journal_path.c_str());
+}
+BENCHMARK(BM_Journal_Replay)->Arg(MB)->Arg(64 * MB)->Unit(benchmark::kMillisecond);
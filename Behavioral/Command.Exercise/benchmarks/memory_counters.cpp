@@ -0,0 +1,187 @@
+#include "memory_counters.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // per thread - counting does not add contention to multithreaded benchmarks
+    thread_local size_t allocation_count = 0;
+    thread_local size_t allocated_bytes = 0;
+
+    void* counted_malloc(std::size_t size) noexcept
+    {
+        ++allocation_count;
+        allocated_bytes += size;
+
+        return std::malloc(size ? size : 1);
+    }
+
+    void* counted_aligned_malloc(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        ++allocation_count;
+        allocated_bytes += size;
+
+        const auto align = static_cast<std::size_t>(alignment);
+        size = (size + align - 1) / align * align; // a multiple of alignment - also for size 0
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : align, align);
+#else
+        return std::aligned_alloc(align, size ? size : align);
+#endif
+    }
+
+    void aligned_free(void* ptr) noexcept
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    void* checked(void* ptr)
+    {
+        if (!ptr)
+            throw std::bad_alloc{};
+
+        return ptr;
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return checked(counted_malloc(size));
+}
+
+void* operator new[](std::size_t size)
+{
+    return checked(counted_malloc(size));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return checked(counted_aligned_malloc(size, alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return checked(counted_aligned_malloc(size, alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return counted_aligned_malloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return counted_aligned_malloc(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    aligned_free(ptr);
+}
+
+MemoryCounters::Snapshot MemoryCounters::current()
+{
+    return Snapshot{allocation_count, allocated_bytes, static_cast<int64_t>(resident_bytes())};
+}
+
+size_t MemoryCounters::resident_bytes()
+{
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+    return counters.WorkingSetSize;
+#elif defined(__linux__)
+    // second field of statm - resident pages
+    size_t total_pages = 0;
+    size_t resident_pages = 0;
+
+    if (std::FILE* statm = std::fopen("/proc/self/statm", "r"))
+    {
+        if (std::fscanf(statm, "%zu %zu", &total_pages, &resident_pages) != 2)
+            resident_pages = 0;
+        std::fclose(statm);
+    }
+
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,53 @@
+#ifndef MEMORY_COUNTERS_HPP
+#define MEMORY_COUNTERS_HPP
+
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Memory usage of benchmarks - the global operator new of the benchmark binary is replaced
+// (memory_counters.cpp) to count allocations made by each thread.
+namespace MemoryCounters
+{
+    struct Snapshot
+    {
+        size_t allocations{};
+        size_t bytes{};
+        int64_t resident_bytes{}; // resident set size of the process (a change of it in a difference)
+
+        Snapshot& operator+=(const Snapshot& other)
+        {
+            allocations += other.allocations;
+            bytes += other.bytes;
+            resident_bytes += other.resident_bytes;
+            return *this;
+        }
+    };
+
+    // allocations made so far by the calling thread
+    Snapshot current();
+
+    // allocations made by the calling thread after start & change of the resident set since start
+    inline Snapshot since(const Snapshot& start)
+    {
+        const Snapshot now = current();
+        return Snapshot{now.allocations - start.allocations, now.bytes - start.bytes, now.resident_bytes - start.resident_bytes};
+    }
+
+    // current resident set size of the process - 0 where it is not available
+    size_t resident_bytes();
+
+    // sets counters: allocations & bytes allocated per iteration, growth of the resident set during
+    // the measured code of a case (the peak RSS of a process would carry over from previous cases)
+    inline void report(benchmark::State& state, const Snapshot& allocated)
+    {
+        state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocated.allocations), benchmark::Counter::kAvgIterations);
+        state.counters["bytes_allocated"] = benchmark::Counter(static_cast<double>(allocated.bytes),
+            benchmark::Counter::kAvgIterations, benchmark::Counter::OneK::kIs1024);
+        state.counters["rss_growth"] = benchmark::Counter(static_cast<double>(allocated.resident_bytes),
+            benchmark::Counter::kDefaults, benchmark::Counter::OneK::kIs1024);
+    }
+}
+
+#endif // MEMORY_COUNTERS_HPP
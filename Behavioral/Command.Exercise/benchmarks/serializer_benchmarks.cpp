@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+
+#include <sstream>
+#include <string>
+
+#include "serializers.hpp"
+
+namespace
+{
+    // stream archives split text on whitespace - payload is a single word
+    std::string make_payload(int64_t size)
+    {
+        return std::string(size, 'a');
+    }
+
+    void payload_sizes(benchmark::internal::Benchmark* bm)
+    {
+        for (int64_t size : {1 << 10, 32 << 10, 1 << 20, 32 << 20, 100 << 20})
+            bm->Arg(size);
+    }
+}
+
+static void BM_StreamOutputSerializer(benchmark::State& state)
+{
+    const auto payload = make_payload(state.range(0));
+
+    for (auto _ : state)
+    {
+        std::stringstream stream;
+        StreamOutputSerializer archive{stream};
+        archive(payload);
+        benchmark::DoNotOptimize(stream);
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StreamOutputSerializer)->Apply(payload_sizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_BinaryOutputSerializer(benchmark::State& state)
+{
+    const auto payload = make_payload(state.range(0));
+    std::string buffer;
+
+    for (auto _ : state)
+    {
+        buffer.clear(); // capacity is reused between iterations
+        BinaryOutputSerializer archive{buffer};
+        archive(payload);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinaryOutputSerializer)->Apply(payload_sizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_StreamInputSerializer(benchmark::State& state)
+{
+    std::stringstream source;
+    source << make_payload(state.range(0));
+    const auto data = source.str();
+
+    for (auto _ : state)
+    {
+        std::stringstream stream{data};
+        StreamInputSerializer archive{stream};
+        std::string payload;
+        archive(payload);
+        benchmark::DoNotOptimize(payload.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StreamInputSerializer)->Apply(payload_sizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_BinaryInputSerializer_String(benchmark::State& state)
+{
+    std::string buffer;
+    BinaryOutputSerializer{buffer}(make_payload(state.range(0)));
+
+    for (auto _ : state)
+    {
+        BinaryInputSerializer archive{buffer};
+        std::string payload;
+        archive(payload);
+        benchmark::DoNotOptimize(payload.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinaryInputSerializer_String)->Apply(payload_sizes)->Unit(benchmark::kMicrosecond);
+
+static void BM_BinaryInputSerializer_StringView(benchmark::State& state)
+{
+    std::string buffer;
+    BinaryOutputSerializer{buffer}(make_payload(state.range(0)));
+
+    for (auto _ : state)
+    {
+        BinaryInputSerializer archive{buffer};
+        std::string_view payload;
+        archive(payload);
+        benchmark::DoNotOptimize(payload.data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BinaryInputSerializer_StringView)->Apply(payload_sizes)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,124 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "clipboard.hpp"
+#include "command.hpp"
+#include "counting_new.hpp"
+#include "text_storage.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    // typed text fits into the small buffer of std::string - only the history is measured
+    class TypingConsole : public Console
+    {
+    public:
+        std::string get_line() override
+        {
+            return "typed";
+        }
+
+        void print(const std::string&) override
+        {
+        }
+    };
+}
+
+template <typename Storage>
+struct CommandHistory_Allocations : Test
+{
+    // long enough for the add buffer of a piece table to be compacted at least once
+    static constexpr int warm_up_cycles = 10'000;
+    static constexpr int measured_cycles = 1'000;
+
+    const std::string initial_text{"The quick brown Fox jumps over the lazy Dog - 0123456789 times!"};
+
+    Document doc{std::make_unique<Storage>(initial_text)};
+    TypingConsole console;
+    SharedClipboard clipboard;
+    CommandHistory cmd_history;
+    ToUpperCmd to_upper_cmd{doc, cmd_history};
+    ClearCmd clear_cmd{doc, cmd_history};
+    AddTextCmd add_text_cmd{doc, console, cmd_history};
+    PasteCmd paste_cmd{doc, clipboard, cmd_history};
+    UndoCmd undo_cmd{console, cmd_history};
+    RedoCmd redo_cmd{console, cmd_history};
+
+    CommandHistory_Allocations()
+    {
+        clipboard.set_content("pasted text longer than a small string buffer");
+    }
+
+    // leaves the document unchanged - the command stays on the undo stack
+    void execute_undo_redo_undo(Command& cmd)
+    {
+        cmd.execute();
+        undo_cmd.execute();
+        redo_cmd.execute();
+        undo_cmd.execute();
+    }
+
+    template <typename Cycle>
+    size_t steady_state_allocations(Cycle cycle)
+    {
+        for (int i = 0; i < warm_up_cycles; ++i)
+            cycle();
+
+        const size_t allocations_before = CountingNew::allocations();
+
+        for (int i = 0; i < measured_cycles; ++i)
+            cycle();
+
+        return CountingNew::allocations() - allocations_before;
+    }
+};
+
+using StorageTypes = Types<StringStorage, PieceTableStorage>;
+TYPED_TEST_SUITE(CommandHistory_Allocations, StorageTypes);
+
+TYPED_TEST(CommandHistory_Allocations, CaseConversionAndClearDoNotUseGlobalHeap)
+{
+    const size_t allocations = this->steady_state_allocations([this] {
+        this->execute_undo_redo_undo(this->to_upper_cmd);
+        this->execute_undo_redo_undo(this->clear_cmd);
+    });
+
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_THAT(this->doc.text(), StrEq(this->initial_text));
+    ASSERT_EQ(this->cmd_history.undone_size(), 1u);
+}
+
+TYPED_TEST(CommandHistory_Allocations, AddTextDoesNotUseGlobalHeap)
+{
+    const size_t allocations = this->steady_state_allocations([this] {
+        this->execute_undo_redo_undo(this->add_text_cmd);
+    });
+
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_THAT(this->doc.text(), StrEq(this->initial_text));
+}
+
+TYPED_TEST(CommandHistory_Allocations, PasteDoesNotUseGlobalHeap)
+{
+    const size_t allocations = this->steady_state_allocations([this] {
+        this->execute_undo_redo_undo(this->paste_cmd);
+    });
+
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_THAT(this->doc.text(), StrEq(this->initial_text));
+}
+
+TYPED_TEST(CommandHistory_Allocations, EditsInTheMiddleDoNotUseGlobalHeap)
+{
+    const std::string text = "inserted in the middle of a document";
+
+    const size_t allocations = this->steady_state_allocations([this, &text] {
+        auto memento = this->doc.create_delta_memento(10, 0, &this->cmd_history.memory_resource());
+        this->doc.replace(10, 0, text);
+        this->doc.set_memento(memento);
+    });
+
+    EXPECT_EQ(allocations, 0u);
+    EXPECT_THAT(this->doc.text(), StrEq(this->initial_text));
+}
@@ -0,0 +1,152 @@
+#include "counting_new.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    std::atomic<size_t> global_allocations{0};
+
+    void* counted_malloc(std::size_t size) noexcept
+    {
+        global_allocations.fetch_add(1, std::memory_order_relaxed);
+
+        return std::malloc(size ? size : 1);
+    }
+
+    void* counted_aligned_malloc(std::size_t size, std::align_val_t alignment) noexcept
+    {
+        global_allocations.fetch_add(1, std::memory_order_relaxed);
+
+        const auto align = static_cast<std::size_t>(alignment);
+        size = (size + align - 1) / align * align; // a multiple of alignment - also for size 0
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : align, align);
+#else
+        return std::aligned_alloc(align, size ? size : align);
+#endif
+    }
+
+    void aligned_free(void* ptr) noexcept
+    {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+
+    void* checked(void* ptr)
+    {
+        if (!ptr)
+            throw std::bad_alloc{};
+
+        return ptr;
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    return checked(counted_malloc(size));
+}
+
+void* operator new[](std::size_t size)
+{
+    return checked(counted_malloc(size));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return counted_malloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    return checked(counted_aligned_malloc(size, alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+    return checked(counted_aligned_malloc(size, alignment));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return counted_aligned_malloc(size, alignment);
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return counted_aligned_malloc(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    aligned_free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept
+{
+    aligned_free(ptr);
+}
+
+size_t CountingNew::allocations()
+{
+    return global_allocations.load();
+}
@@ -0,0 +1,15 @@
+#ifndef COUNTING_NEW_HPP
+#define COUNTING_NEW_HPP
+
+#include <cstddef>
+
+// The global operator new & delete (all forms) are replaced in counting_new.cpp to count allocations -
+// defined in a separate translation unit, so that the compiler does not pair inlined deletes with new.
+// Linked only into the allocation tests - other tests keep the default allocator.
+namespace CountingNew
+{
+    // allocations made so far by all threads
+    size_t allocations();
+}
+
+#endif // COUNTING_NEW_HPP
@@ -4,6 +4,7 @@
 #include "mocks/mock_command.hpp"
 #include "mocks/mock_console.hpp"
 #include <memory>
+#include <sstream>
 
 using namespace ::testing;
 
@@ -78,3 +79,77 @@ TEST_F(ApplicationTests_MainLoop, UnknownCommandPrintsErrorMesssage)
     
     app.run();
 }
+
+struct ApplicationTests_Batch : ApplicationTests
+{
+    std::istringstream script;
+    std::ostringstream output;
+    ScriptConsole console{script, output};
+    Application app{console};
+    std::shared_ptr<MockCommand> mq_cmd;
+
+    void SetUp() override
+    {
+        mq_cmd = std::make_shared<NiceMock<MockCommand>>();
+
+        app.add_command("cmd", mq_cmd);
+    }
+};
+
+TEST_F(ApplicationTests_Batch, ExecutesAllCommandsFromScript)
+{
+    script.str("cmd\nCMD\nCmd\n");
+    EXPECT_CALL(*mq_cmd, execute()).Times(3);
+
+    auto stats = app.run_batch(script);
+
+    ASSERT_THAT(stats.commands, Eq(3));
+}
+
+TEST_F(ApplicationTests_Batch, ExitStopsExecution)
+{
+    script.str("cmd\nexit\ncmd\n");
+    EXPECT_CALL(*mq_cmd, execute()).Times(1);
+
+    app.run_batch(script);
+}
+
+TEST_F(ApplicationTests_Batch, DoesNotShowPrompt)
+{
+    script.str("cmd\n");
+
+    app.run_batch(script);
+
+    ASSERT_THAT(output.str(), Not(HasSubstr(Messages::msg_prompt)));
+}
+
+TEST_F(ApplicationTests_Batch, UnknownCommandPrintsErrorMessage)
+{
+    script.str("unknown\n");
+
+    app.run_batch(script);
+
+    ASSERT_THAT(output.str(), HasSubstr(Messages::msg_unknown_cmd + std::string("UNKNOWN")));
+}
+
+TEST_F(ApplicationTests_Batch, ReportsThroughput)
+{
+    script.str("cmd\ncmd\n");
+
+    app.run_batch(script);
+
+    ASSERT_THAT(output.str(), HasSubstr(Messages::msg_batch_summary + std::string("2 commands")));
+    ASSERT_THAT(output.str(), HasSubstr("commands/sec"));
+}
+
+TEST_F(ApplicationTests_Batch, CommandsReadArgumentsFromScript)
+{
+    Document doc;
+    CommandHistory history;
+    app.add_command("AddText", std::make_shared<AddTextCmd>(doc, console, history));
+    script.str("AddText\nabc\nAddText\ndef\n");
+
+    app.run_batch(script);
+
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+}
@@ -0,0 +1,85 @@
+#include <algorithm>
+#include <cctype>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "case_conversion.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    std::string all_bytes(size_t repeat)
+    {
+        std::string text;
+        for (size_t r = 0; r < repeat; ++r)
+            for (int c = 0; c < 256; ++c)
+                text.push_back(static_cast<char>(c));
+        return text;
+    }
+
+    std::string reference(std::string text, bool upper)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [upper](char c) {
+            const auto uc = static_cast<unsigned char>(c);
+            return static_cast<char>(upper ? std::toupper(uc) : std::tolower(uc));
+        });
+        return text;
+    }
+}
+
+TEST(CaseConversionTests, ToUpperConvertsAsciiLetters)
+{
+    std::string text = "abc XYZ 123 {`@[} the quick brown fox jumps over the lazy dog";
+
+    CaseConversion::to_upper(text.data(), text.size());
+
+    ASSERT_THAT(text, StrEq("ABC XYZ 123 {`@[} THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG"));
+}
+
+TEST(CaseConversionTests, ToLowerConvertsAsciiLetters)
+{
+    std::string text = "ABC xyz 123 {`@[} THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG";
+
+    CaseConversion::to_lower(text.data(), text.size());
+
+    ASSERT_THAT(text, StrEq("abc xyz 123 {`@[} the quick brown fox jumps over the lazy dog"));
+}
+
+TEST(CaseConversionTests, MatchesCharByCharConversionForAllBytesAndAlignments)
+{
+    const std::string source = all_bytes(3);
+
+    for (size_t offset = 0; offset < 40; ++offset)
+    {
+        for (size_t size : {0u, 1u, 15u, 16u, 17u, 31u, 32u, 33u, 100u, 700u})
+        {
+            const std::string expected_upper = reference(source.substr(offset, size), true);
+            const std::string expected_lower = reference(source.substr(offset, size), false);
+
+            std::string upper = source.substr(offset, size);
+            CaseConversion::to_upper(upper.data(), upper.size());
+            ASSERT_THAT(upper, Eq(expected_upper)) << "offset: " << offset << ", size: " << size;
+
+            std::string lower = source.substr(offset, size);
+            CaseConversion::to_lower(lower.data(), lower.size());
+            ASSERT_THAT(lower, Eq(expected_lower)) << "offset: " << offset << ", size: " << size;
+        }
+    }
+}
+
+TEST(CaseConversionTests, NonAsciiBytesDoNotStopConversionOfFollowingBlocks)
+{
+    std::string text = "\xC3\xA9" + std::string(100, 'a');
+
+    CaseConversion::to_upper(text.data(), text.size());
+
+    ASSERT_THAT(text, StrEq("\xC3\xA9" + std::string(100, 'A')));
+}
+
+TEST(CaseConversionTests, KernelIsSelected)
+{
+    ASSERT_THAT(CaseConversion::kernel_name(), AnyOf(StrEq("avx2"), StrEq("sse2"), StrEq("scalar")));
+}
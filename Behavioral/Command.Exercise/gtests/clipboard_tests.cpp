@@ -0,0 +1,93 @@
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "clipboard.hpp"
+
+using namespace ::testing;
+
+TEST(SharedClipboardTests, IsEmptyByDefault)
+{
+    SharedClipboard clipboard;
+
+    ASSERT_THAT(clipboard.content(), StrEq(""));
+    ASSERT_THAT(*clipboard.snapshot(), StrEq(""));
+}
+
+TEST(SharedClipboardTests, SetContentPublishesNewSnapshot)
+{
+    SharedClipboard clipboard;
+
+    clipboard.set_content("abc");
+
+    ASSERT_THAT(clipboard.content(), StrEq("abc"));
+    ASSERT_THAT(*clipboard.snapshot(), StrEq("abc"));
+}
+
+TEST(SharedClipboardTests, SnapshotsAreSharedNotCopied)
+{
+    SharedClipboard clipboard;
+    clipboard.set_content("abc");
+
+    ASSERT_THAT(clipboard.snapshot().get(), Eq(clipboard.snapshot().get()));
+}
+
+TEST(SharedClipboardTests, SnapshotIsNotChangedBySetContent)
+{
+    SharedClipboard clipboard;
+    clipboard.set_content("abc");
+
+    auto snapshot = clipboard.snapshot();
+    clipboard.set_content("def");
+
+    ASSERT_THAT(*snapshot, StrEq("abc"));
+    ASSERT_THAT(*clipboard.snapshot(), StrEq("def"));
+}
+
+TEST(SharedClipboardTests, HeldSnapshotsDoNotBlockWriters)
+{
+    SharedClipboard clipboard;
+    clipboard.set_content("abc");
+    auto first = clipboard.snapshot();
+
+    clipboard.set_content("def");
+    auto second = clipboard.snapshot();
+    clipboard.set_content("ghi");
+
+    ASSERT_THAT(*first, StrEq("abc"));
+    ASSERT_THAT(*second, StrEq("def"));
+    ASSERT_THAT(clipboard.content(), StrEq("ghi"));
+}
+
+TEST(SharedClipboardTests, ReadersSeeWholeValuesWhileWriterPublishes)
+{
+    SharedClipboard clipboard;
+    const std::string a(1000, 'a');
+    const std::string b(1000, 'b');
+    clipboard.set_content(a);
+
+    std::vector<std::thread> readers;
+    std::vector<int> torn_reads(4);
+    for (size_t i = 0; i < torn_reads.size(); ++i)
+    {
+        readers.emplace_back([&, i] {
+            for (int j = 0; j < 10'000; ++j)
+            {
+                auto snapshot = clipboard.snapshot();
+                if (*snapshot != a && *snapshot != b)
+                    ++torn_reads[i];
+            }
+        });
+    }
+
+    for (int j = 0; j < 10'000; ++j)
+        clipboard.set_content(j % 2 ? a : b);
+
+    for (auto& reader : readers)
+        reader.join();
+
+    ASSERT_THAT(torn_reads, Each(0));
+}
@@ -0,0 +1,296 @@
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "command.hpp"
+#include "mocks/mock_clipboard.hpp"
+#include "mocks/mock_console.hpp"
+
+using namespace ::testing;
+
+struct CommandHistoryTests : Test
+{
+    Document doc{"abc"};
+    NiceMock<MockConsole> mq_console;
+    NiceMock<MockClipboard> mq_clipboard;
+};
+
+struct CommandHistory_UndoRedo : CommandHistoryTests
+{
+    CommandHistory cmd_history;
+    AddTextCmd add_text_cmd{doc, mq_console, cmd_history};
+    PasteCmd paste_cmd{doc, mq_clipboard, cmd_history};
+    UndoCmd undo_cmd{mq_console, cmd_history};
+    RedoCmd redo_cmd{mq_console, cmd_history};
+};
+
+TEST_F(CommandHistory_UndoRedo, RedoRestoresUndoneText)
+{
+    EXPECT_CALL(mq_console, get_line()).WillOnce(Return("def"));
+    add_text_cmd.execute();
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+
+    redo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+    ASSERT_THAT(cmd_history.size(), Eq(1));
+    ASSERT_THAT(cmd_history.undone_size(), Eq(0));
+}
+
+TEST_F(CommandHistory_UndoRedo, RedoDoesNotReadClipboardAgain)
+{
+    EXPECT_CALL(mq_clipboard, content()).Times(1).WillOnce(Return("def"));
+    paste_cmd.execute();
+
+    undo_cmd.execute();
+    redo_cmd.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+}
+
+TEST_F(CommandHistory_UndoRedo, UndoAfterRedo)
+{
+    ON_CALL(mq_console, get_line()).WillByDefault(Return("def"));
+    add_text_cmd.execute();
+
+    undo_cmd.execute();
+    redo_cmd.execute();
+    undo_cmd.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(CommandHistory_UndoRedo, NewCommandDiscardsUndoneCommands)
+{
+    ON_CALL(mq_console, get_line()).WillByDefault(Return("x"));
+    add_text_cmd.execute();
+    undo_cmd.execute();
+    ASSERT_THAT(cmd_history.undone_size(), Eq(1));
+
+    add_text_cmd.execute();
+
+    ASSERT_THAT(cmd_history.undone_size(), Eq(0));
+}
+
+TEST_F(CommandHistory_UndoRedo, RedoWithEmptyHistoryPrintsMessage)
+{
+    EXPECT_CALL(mq_console, print("No undone commands. Nothing to redo.")).Times(1);
+
+    redo_cmd.execute();
+}
+
+//-----------------------------------------------------------------
+
+struct CommandHistory_Budget : CommandHistoryTests
+{
+    static constexpr size_t budget = 4096;
+
+    CommandHistory cmd_history{budget};
+    ClearCmd clear_cmd{doc, cmd_history};
+};
+
+TEST_F(CommandHistory_Budget, FootprintIncludesMementos)
+{
+    doc = Document{std::string(1000, 'a')};
+    clear_cmd.execute();
+
+    ASSERT_THAT(cmd_history.footprint(), Ge(1000u));
+}
+
+TEST_F(CommandHistory_Budget, OldestCommandsAreEvicted)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        doc = Document{std::string(1000, 'a')};
+        clear_cmd.execute();
+    }
+
+    ASSERT_THAT(cmd_history.footprint(), Le(budget));
+    ASSERT_THAT(cmd_history.size(), Lt(10u));
+    ASSERT_THAT(cmd_history.size(), Gt(0u));
+}
+
+TEST_F(CommandHistory_Budget, MostRecentCommandIsKeptEvenIfOverBudget)
+{
+    doc = Document{std::string(2 * budget, 'a')};
+    clear_cmd.execute();
+
+    ASSERT_THAT(cmd_history.size(), Eq(1));
+}
+
+//-----------------------------------------------------------------
+
+struct CommandHistory_Spill : CommandHistoryTests
+{
+    static constexpr size_t budget = 8192;
+
+    const std::string spill_file_path = ::testing::TempDir() + "command_history_spill.bin";
+    CommandHistory cmd_history{budget, spill_file_path};
+    AddTextCmd add_text_cmd{doc, mq_console, cmd_history};
+    ToUpperCmd to_upper_cmd{doc, cmd_history};
+    ClearCmd clear_cmd{doc, cmd_history};
+    UndoCmd undo_cmd{mq_console, cmd_history};
+};
+
+TEST_F(CommandHistory_Spill, ColdMementosAreSpilledInsteadOfEvicted)
+{
+    const std::string text(1000, 'a');
+    ON_CALL(mq_console, get_line()).WillByDefault(Return(text));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        add_text_cmd.execute();
+        clear_cmd.execute();
+    }
+
+    ASSERT_THAT(cmd_history.size(), Eq(20));
+    ASSERT_THAT(cmd_history.footprint(), Le(budget));
+}
+
+TEST_F(CommandHistory_Spill, DeepUndoFaultsMementosBackIn)
+{
+    const std::string text = "text with spaces";
+    ON_CALL(mq_console, get_line()).WillByDefault(Return(std::string(1000, 'x')));
+    doc = Document{text};
+
+    to_upper_cmd.execute();
+    for (int i = 0; i < 10; ++i)
+    {
+        add_text_cmd.execute();
+        clear_cmd.execute();
+    }
+
+    for (int i = 0; i < 21; ++i)
+        undo_cmd.execute();
+
+    ASSERT_THAT(doc.text(), StrEq(text));
+}
+
+TEST_F(CommandHistory_Spill, SpillFileDoesNotGrowOverRepeatedUndoAndRedo)
+{
+    ON_CALL(mq_console, get_line()).WillByDefault(Return(std::string(1000, 'x')));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        add_text_cmd.execute();
+        clear_cmd.execute();
+    }
+
+    RedoCmd redo_cmd{mq_console, cmd_history};
+    auto undo_and_redo_all = [&] {
+        for (int i = 0; i < 20; ++i)
+            undo_cmd.execute();
+        for (int i = 0; i < 20; ++i)
+            redo_cmd.execute();
+    };
+
+    undo_and_redo_all();
+    const uint64_t size_after_first_cycle = cmd_history.spill_file_size();
+
+    for (int cycle = 0; cycle < 50; ++cycle)
+        undo_and_redo_all();
+
+    ASSERT_THAT(cmd_history.spill_file_size(), Le(2 * size_after_first_cycle));
+    ASSERT_THAT(size_after_first_cycle, Gt(0u));
+    ASSERT_THAT(cmd_history.size(), Eq(20));
+}
+
+//-----------------------------------------------------------------
+
+struct CommandHistory_Coalescing : CommandHistoryTests
+{
+    CommandHistory cmd_history;
+    AddTextCmd add_text_cmd{doc, mq_console, cmd_history};
+    PasteCmd paste_cmd{doc, mq_clipboard, cmd_history};
+    ToUpperCmd to_upper_cmd{doc, cmd_history};
+    UndoCmd undo_cmd{mq_console, cmd_history};
+
+    void SetUp() override
+    {
+        cmd_history.set_coalescing(true);
+        ON_CALL(mq_console, get_line()).WillByDefault(Return("x"));
+        ON_CALL(mq_clipboard, content()).WillByDefault(Return("yz"));
+    }
+};
+
+TEST_F(CommandHistory_Coalescing, ConsecutiveAppendsAreMergedIntoOneUndoStep)
+{
+    for (int i = 0; i < 100; ++i)
+        add_text_cmd.execute();
+
+    ASSERT_THAT(cmd_history.size(), Eq(1));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(CommandHistory_Coalescing, AddTextAndPasteAreMerged)
+{
+    add_text_cmd.execute();
+    paste_cmd.execute();
+    add_text_cmd.execute();
+
+    ASSERT_THAT(cmd_history.size(), Eq(1));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(CommandHistory_Coalescing, DifferentCommandsAreNotMerged)
+{
+    add_text_cmd.execute();
+    to_upper_cmd.execute();
+    add_text_cmd.execute();
+
+    ASSERT_THAT(cmd_history.size(), Eq(3));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("ABCX"));
+}
+
+TEST_F(CommandHistory_Coalescing, RepeatedCaseConversionIsMerged)
+{
+    to_upper_cmd.execute();
+    to_upper_cmd.execute();
+
+    ASSERT_THAT(cmd_history.size(), Eq(1));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(CommandHistory_Coalescing, CommandsOnOtherDocumentsAreNotMerged)
+{
+    Document other_doc{"def"};
+    AddTextCmd other_add_text_cmd{other_doc, mq_console, cmd_history};
+
+    add_text_cmd.execute();
+    other_add_text_cmd.execute();
+
+    ASSERT_THAT(cmd_history.size(), Eq(2));
+}
+
+TEST_F(CommandHistory_Coalescing, RedoRestoresMergedAppends)
+{
+    RedoCmd redo_cmd{mq_console, cmd_history};
+
+    add_text_cmd.execute();
+    paste_cmd.execute();
+    undo_cmd.execute();
+    redo_cmd.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("abcxyz"));
+}
+
+TEST_F(CommandHistory_Coalescing, IsDisabledByDefault)
+{
+    CommandHistory history;
+    AddTextCmd cmd{doc, mq_console, history};
+
+    cmd.execute();
+    cmd.execute();
+
+    ASSERT_THAT(history.size(), Eq(2));
+}
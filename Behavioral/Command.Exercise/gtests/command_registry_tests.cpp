@@ -0,0 +1,68 @@
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "command_registry.hpp"
+#include "mocks/mock_command.hpp"
+
+using namespace ::testing;
+
+struct CommandRegistryTests : Test
+{
+    CommandRegistry registry;
+    std::shared_ptr<MockCommand> print_cmd = std::make_shared<MockCommand>();
+    std::shared_ptr<MockCommand> undo_cmd = std::make_shared<MockCommand>();
+};
+
+TEST_F(CommandRegistryTests, FindsRegisteredCommands)
+{
+    registry.add("Print", print_cmd);
+    registry.add("Undo", undo_cmd);
+
+    ASSERT_THAT(registry.find("PRINT"), Eq(print_cmd.get()));
+    ASSERT_THAT(registry.find("UNDO"), Eq(undo_cmd.get()));
+}
+
+TEST_F(CommandRegistryTests, LookupIsCaseInsensitive)
+{
+    registry.add("ToUpper", print_cmd);
+
+    ASSERT_THAT(registry.find("toupper"), Eq(print_cmd.get()));
+    ASSERT_THAT(registry.find("tOuPpEr"), Eq(print_cmd.get()));
+}
+
+TEST_F(CommandRegistryTests, UnknownNameReturnsNull)
+{
+    ASSERT_THAT(registry.find("Print"), IsNull());
+
+    registry.add("Print", print_cmd);
+
+    ASSERT_THAT(registry.find("Prin"), IsNull());
+    ASSERT_THAT(registry.find("Prints"), IsNull());
+    ASSERT_THAT(registry.find(""), IsNull());
+}
+
+TEST_F(CommandRegistryTests, FirstRegistrationOfNameWins)
+{
+    ASSERT_TRUE(registry.add("Print", print_cmd));
+    ASSERT_FALSE(registry.add("PRINT", undo_cmd));
+
+    ASSERT_THAT(registry.find("print"), Eq(print_cmd.get()));
+    ASSERT_THAT(registry.size(), Eq(1));
+}
+
+TEST_F(CommandRegistryTests, ManyCommandsHaveNoCollisions)
+{
+    std::vector<std::shared_ptr<MockCommand>> cmds;
+    for (int i = 0; i < 500; ++i)
+    {
+        cmds.push_back(std::make_shared<MockCommand>());
+        registry.add("Cmd" + std::to_string(i), cmds.back());
+    }
+
+    for (int i = 0; i < 500; ++i)
+        ASSERT_THAT(registry.find("cmd" + std::to_string(i)), Eq(cmds[i].get()));
+}
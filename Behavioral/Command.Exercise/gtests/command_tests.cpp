@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 
 #include "command.hpp"
+#include "command_registry.hpp"
 #include "document.hpp"
 #include "mocks/mock_clipboard.hpp"
 #include "mocks/mock_console.hpp"
@@ -191,6 +192,116 @@ TEST_F(PasteCmd_Undo, DocumentStateIsRestored)
 
 //-----------------------------------------------------------------
 
+struct FindReplaceCmd_Execute : ReversibleCmdTests
+{
+    FindReplaceCmd find_replace_cmd{doc, mq_console, cmd_history};
+
+    void SetUp() override
+    {
+        doc = Document{"abc abc"};
+        EXPECT_CALL(mq_console, get_line()).WillOnce(Return("bc")).WillOnce(Return("XYZ"));
+    }
+};
+
+TEST_F(FindReplaceCmd_Execute, ReplacesAllOccurrences)
+{
+    EXPECT_CALL(mq_console, print(_)).Times(AnyNumber());
+    EXPECT_CALL(mq_console, print("Replaced: 2")).Times(1);
+
+    find_replace_cmd.execute();
+
+    ASSERT_THAT(doc.text(), StrEq("aXYZ aXYZ"));
+}
+
+TEST_F(FindReplaceCmd_Execute, CommandIsStoredInHistory)
+{
+    find_replace_cmd.execute();
+
+    ASSERT_THAT(cmd_history.size(), Eq(1));
+}
+
+struct FindReplaceCmd_Undo : FindReplaceCmd_Execute
+{
+};
+
+TEST_F(FindReplaceCmd_Undo, RestoresDocumentState)
+{
+    find_replace_cmd.execute();
+
+    auto last_cmd = cmd_history.pop_last_command();
+    last_cmd->undo();
+
+    ASSERT_THAT(doc.text(), StrEq("abc abc"));
+}
+
+TEST_F(FindReplaceCmd_Undo, RedoReplacesAgainWithoutAskingForInput)
+{
+    find_replace_cmd.execute();
+
+    auto last_cmd = cmd_history.pop_last_command();
+    last_cmd->undo();
+    last_cmd->redo();
+
+    ASSERT_THAT(doc.text(), StrEq("aXYZ aXYZ"));
+}
+
+//-----------------------------------------------------------------
+
+// a registered command is a prototype moved into the history on every execution
+struct RegisteredCmd_ExecutedTwice : ReversibleCmdTests
+{
+    CommandRegistry registry;
+    UndoCmd undo_cmd{mq_console, cmd_history};
+
+    void SetUp() override
+    {
+        registry.add("AddText", std::make_shared<AddTextCmd>(doc, mq_console, cmd_history));
+        registry.add("FindReplace", std::make_shared<FindReplaceCmd>(doc, mq_console, cmd_history));
+    }
+
+    void execute_twice(std::string_view name)
+    {
+        Command* cmd = registry.find(name);
+        cmd->execute();
+        cmd->execute();
+    }
+};
+
+TEST_F(RegisteredCmd_ExecutedTwice, AddTextUndoesBothExecutions)
+{
+    EXPECT_CALL(mq_console, get_line()).WillOnce(Return("def")).WillOnce(Return("ghi"));
+
+    execute_twice("AddText");
+    ASSERT_THAT(doc.text(), StrEq("abcdefghi"));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abcdef"));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(RegisteredCmd_ExecutedTwice, FindReplaceUndoesBothExecutions)
+{
+    doc = Document{"abc abc"};
+    EXPECT_CALL(mq_console, get_line())
+        .WillOnce(Return("bc"))
+        .WillOnce(Return("XYZ"))
+        .WillOnce(Return("XYZ"))
+        .WillOnce(Return("-"));
+
+    execute_twice("FindReplace");
+    ASSERT_THAT(doc.text(), StrEq("a- a-"));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("aXYZ aXYZ"));
+
+    undo_cmd.execute();
+    ASSERT_THAT(doc.text(), StrEq("abc abc"));
+}
+
+//-----------------------------------------------------------------
+
 struct UndoCmd_Execute : CommandTests
 {
     CommandHistory cmd_history;
@@ -202,7 +313,9 @@ struct MockReversibleCommand : ReversibleCommand
 {
     MOCK_METHOD0(execute, void());
     MOCK_METHOD0(undo, void());
+    MOCK_METHOD0(redo, void());
     MOCK_CONST_METHOD0(clone, ReversibleCommandPtr());
+    MOCK_CONST_METHOD0(footprint, size_t());
 };
 
 TEST_F(UndoCmd_Execute, PopsLastCommandFromHistory)
@@ -0,0 +1,168 @@
+#include <sstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "buffered_console.hpp"
+#include "console.hpp"
+
+using namespace ::testing;
+
+struct ScriptConsoleTests : Test
+{
+    std::istringstream in{"first line\nsecond line\n"};
+    std::ostringstream out;
+};
+
+TEST_F(ScriptConsoleTests, ReadsLinesFromScript)
+{
+    ScriptConsole console{in, out};
+
+    ASSERT_THAT(console.get_line(), StrEq("first line"));
+    ASSERT_THAT(console.get_line(), StrEq("second line"));
+}
+
+TEST_F(ScriptConsoleTests, OutputIsBufferedUntilFlush)
+{
+    ScriptConsole console{in, out};
+
+    console.print("abc");
+    ASSERT_THAT(out.str(), IsEmpty());
+
+    console.flush();
+    ASSERT_THAT(out.str(), StrEq("abc\n"));
+}
+
+TEST_F(ScriptConsoleTests, OutputIsFlushedWhenBufferIsFull)
+{
+    ScriptConsole console{in, out, 8};
+
+    console.print("abc");
+    console.print("defgh");
+
+    ASSERT_THAT(out.str(), StrEq("abc\ndefgh\n"));
+}
+
+TEST_F(ScriptConsoleTests, OutputIsFlushedOnDestruction)
+{
+    {
+        ScriptConsole console{in, out};
+        console.print("abc");
+    }
+
+    ASSERT_THAT(out.str(), StrEq("abc\n"));
+}
+
+//--------------------------------------------------------------------------------
+// BufferedConsole reading and writing pipes
+struct BufferedConsoleTests : Test
+{
+    int input[2]{};
+    int output[2]{};
+
+    BufferedConsoleTests()
+    {
+        if (::pipe(input) != 0 || ::pipe(output) != 0)
+            throw std::runtime_error("Pipe not created");
+    }
+
+    ~BufferedConsoleTests() override
+    {
+        for (int fd : {input[0], input[1], output[0], output[1]})
+            if (fd >= 0)
+                ::close(fd);
+    }
+
+    void write_input(const std::string& text)
+    {
+        ASSERT_EQ(::write(input[1], text.data(), text.size()), static_cast<ssize_t>(text.size()));
+        ::close(input[1]);
+        input[1] = -1;
+    }
+
+    // everything written to the output pipe so far
+    std::string written_output()
+    {
+        ::fcntl(output[0], F_SETFL, O_NONBLOCK);
+
+        std::string result;
+        char buffer[4096];
+        ssize_t count;
+        while ((count = ::read(output[0], buffer, sizeof(buffer))) > 0)
+            result.append(buffer, static_cast<size_t>(count));
+
+        return result;
+    }
+};
+
+TEST_F(BufferedConsoleTests, ReadsLinesSpanningManyReadBuffers)
+{
+    write_input("first line\nsecond line\n\nlast");
+    BufferedConsoleOptions options;
+    options.read_buffer_size = 4;
+    BufferedConsole console{input[0], output[1], options};
+
+    ASSERT_THAT(console.get_line(), StrEq("first line"));
+    ASSERT_THAT(console.get_line(), StrEq("second line"));
+    ASSERT_THAT(console.get_line(), StrEq(""));
+    ASSERT_THAT(console.get_line(), StrEq("last"));
+    ASSERT_THAT(console.get_line(), StrEq(""));
+}
+
+TEST_F(BufferedConsoleTests, OutputIsBufferedUntilFlush)
+{
+    BufferedConsole console{input[0], output[1]};
+
+    console.print("abc");
+    ASSERT_THAT(written_output(), IsEmpty());
+
+    console.flush();
+    ASSERT_THAT(written_output(), StrEq("abc\n"));
+}
+
+TEST_F(BufferedConsoleTests, OutputIsFlushedWhenBufferIsFull)
+{
+    BufferedConsoleOptions options;
+    options.write_buffer_size = 8;
+    BufferedConsole console{input[0], output[1], options};
+
+    console.print("abc");
+    console.print("defgh");
+
+    ASSERT_THAT(written_output(), StrEq("abc\ndefgh\n"));
+}
+
+TEST_F(BufferedConsoleTests, OutputIsFlushedBeforeReadingInput)
+{
+    write_input("Print\n");
+    BufferedConsole console{input[0], output[1]};
+
+    console.print(">");
+    console.get_line();
+
+    ASSERT_THAT(written_output(), StrEq(">\n"));
+}
+
+TEST_F(BufferedConsoleTests, OutputThreadWritesLinesInOrder)
+{
+    BufferedConsoleOptions options;
+    options.write_buffer_size = 16;
+    options.output_thread = true;
+
+    std::string expected;
+    {
+        BufferedConsole console{input[0], output[1], options};
+
+        for (int i = 0; i < 1000; ++i) // about 4 KB - fits in a pipe
+        {
+            console.print(std::to_string(i));
+            expected += std::to_string(i) + "\n";
+        }
+    }
+
+    ASSERT_EQ(written_output(), expected);
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "document_engine.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    class FunctionCmd : public Command
+    {
+        std::function<void()> action_;
+
+    public:
+        explicit FunctionCmd(std::function<void()> action)
+            : action_{std::move(action)}
+        {
+        }
+
+        void execute() override
+        {
+            action_();
+        }
+    };
+
+    CommandPtr make_cmd(std::function<void()> action)
+    {
+        return std::make_unique<FunctionCmd>(std::move(action));
+    }
+}
+
+TEST(WorkStealingPoolTests, ExecutesAllTasksBeforeDestruction)
+{
+    std::atomic<int> counter{0};
+
+    {
+        WorkStealingPool pool{4};
+        for (int i = 0; i < 1000; ++i)
+            pool.submit([&counter] { ++counter; });
+    }
+
+    ASSERT_THAT(counter.load(), Eq(1000));
+}
+
+TEST(WorkStealingPoolTests, TasksSubmittedFromOutsideAreTakenInSubmissionOrder)
+{
+    std::vector<int> order;
+    std::atomic<bool> started{false};
+    std::atomic<bool> released{false};
+
+    {
+        WorkStealingPool pool{1};
+        pool.submit([&] {
+            started = true;
+            while (!released)
+                std::this_thread::yield();
+        });
+
+        while (!started)
+            std::this_thread::yield();
+
+        for (int i = 0; i < 100; ++i)
+            pool.submit([&order, i] { order.push_back(i); });
+
+        released = true;
+    }
+
+    std::vector<int> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    ASSERT_THAT(order, ContainerEq(expected));
+}
+
+TEST(WorkStealingPoolTests, TasksCanSubmitTasks)
+{
+    std::atomic<int> counter{0};
+
+    {
+        WorkStealingPool pool{2};
+        for (int i = 0; i < 10; ++i)
+        {
+            pool.submit([&] {
+                for (int j = 0; j < 10; ++j)
+                    pool.submit([&counter] { ++counter; });
+            });
+        }
+    }
+
+    ASSERT_THAT(counter.load(), Eq(100));
+}
+
+//-----------------------------------------------------------------
+
+struct DocumentEngineTests : Test
+{
+    DocumentEngine engine{4};
+};
+
+TEST_F(DocumentEngineTests, CommandsOfDocumentAreExecutedInSubmissionOrder)
+{
+    auto id = engine.add_document();
+    std::vector<int> order; // not synchronized - the strand guarantees exclusive access
+    std::atomic<bool> running{false};
+    std::atomic<int> overlaps{0};
+
+    for (int i = 0; i < 1000; ++i)
+    {
+        engine.submit(id, make_cmd([&, i] {
+            if (running.exchange(true))
+                ++overlaps;
+            order.push_back(i);
+            running = false;
+        }));
+    }
+    engine.wait();
+
+    ASSERT_THAT(overlaps.load(), Eq(0));
+    ASSERT_THAT(order.size(), Eq(1000));
+    ASSERT_TRUE(std::is_sorted(order.begin(), order.end()));
+}
+
+TEST_F(DocumentEngineTests, DocumentsAreProcessedInParallel)
+{
+    auto first = engine.add_document();
+    auto second = engine.add_document();
+    std::promise<void> second_started;
+    auto second_started_future = second_started.get_future();
+    bool first_saw_second = false;
+
+    // the first command waits for a command of the other document - it would never run on a single strand
+    engine.submit(first, make_cmd([&] {
+        first_saw_second = second_started_future.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+    }));
+    engine.submit(second, make_cmd([&] { second_started.set_value(); }));
+    engine.wait();
+
+    ASSERT_TRUE(first_saw_second);
+}
+
+TEST_F(DocumentEngineTests, ExecutesDocumentCommands)
+{
+    auto id = engine.add_document("abc");
+
+    engine.submit(id, std::make_unique<ToUpperCmd>(engine.document(id), engine.history(id)));
+    engine.wait();
+
+    ASSERT_THAT(engine.document(id).text(), StrEq("ABC"));
+    ASSERT_THAT(engine.history(id).size(), Eq(1));
+}
+
+TEST_F(DocumentEngineTests, CountsExecutedCommandsAndLatency)
+{
+    auto id = engine.add_document();
+
+    for (int i = 0; i < 10; ++i)
+        engine.submit(id, make_cmd([] { std::this_thread::sleep_for(std::chrono::microseconds(100)); }));
+    engine.wait();
+
+    auto stats = engine.stats(id);
+    ASSERT_THAT(stats.executed, Eq(10));
+    ASSERT_THAT(stats.failed, Eq(0));
+    ASSERT_THAT(stats.queue_depth, Eq(0));
+    ASSERT_THAT(stats.max_latency, Ge(std::chrono::microseconds(100)));
+    ASSERT_THAT(stats.avg_latency(), Le(stats.max_latency));
+}
+
+TEST_F(DocumentEngineTests, FailedCommandsAreCountedAndDoNotStopStrand)
+{
+    auto id = engine.add_document();
+    bool executed_after_failure = false;
+
+    engine.submit(id, make_cmd([] { throw std::runtime_error("error"); }));
+    engine.submit(id, make_cmd([&] { executed_after_failure = true; }));
+    engine.wait();
+
+    ASSERT_TRUE(executed_after_failure);
+    ASSERT_THAT(engine.stats(id).failed, Eq(1));
+    ASSERT_THAT(engine.stats(id).executed, Eq(2));
+}
+
+TEST_F(DocumentEngineTests, UnknownDocumentIdThrows)
+{
+    ASSERT_THROW(engine.submit(42, make_cmd([] {})), std::out_of_range);
+}
@@ -1,4 +1,8 @@
 #include <algorithm>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -104,4 +108,165 @@ TEST_F(Document_Memento, RestoresThePreviousState)
     doc.set_memento(snapshot);
 
     ASSERT_THAT(doc.text(), StrEq("abc"));
-}
\ No newline at end of file
+}
+
+//-----------------------------------------------------------------
+
+struct Document_DeltaMemento : Test
+{
+    Document doc{"abc def ghi"};
+};
+
+TEST_F(Document_DeltaMemento, RestoresReplacedRegion)
+{
+    auto delta = doc.create_delta_memento(4, 3);
+    doc.replace(4, 3, "XY");
+    doc.set_memento(delta);
+
+    ASSERT_THAT(doc.text(), StrEq("abc def ghi"));
+}
+
+TEST_F(Document_DeltaMemento, RestoresGrownRegion)
+{
+    auto delta = doc.create_delta_memento(4, 3);
+    doc.replace(4, 3, "LONGER TEXT");
+    doc.set_memento(delta);
+
+    ASSERT_THAT(doc.text(), StrEq("abc def ghi"));
+}
+
+TEST_F(Document_DeltaMemento, RestoresClearedDocument)
+{
+    auto delta = doc.create_delta_memento(0, doc.length());
+    doc.clear();
+    doc.set_memento(delta);
+
+    ASSERT_THAT(doc.text(), StrEq("abc def ghi"));
+}
+
+TEST_F(Document_DeltaMemento, RestoresCaseConversion)
+{
+    doc = Document{"aBc DeF 123"};
+
+    auto delta = doc.create_case_memento(Document::LetterCase::upper);
+    doc.to_upper();
+    ASSERT_THAT(doc.text(), StrEq("ABC DEF 123"));
+
+    doc.set_memento(delta);
+    ASSERT_THAT(doc.text(), StrEq("aBc DeF 123"));
+}
+
+TEST_F(Document_DeltaMemento, RestoresCaseConversionOfLongDocument)
+{
+    std::string text(1000, 'X');
+    text[130] = 'y';
+    text[700] = 'z';
+    doc = Document{text};
+
+    auto delta = doc.create_case_memento(Document::LetterCase::lower);
+    doc.to_lower();
+    doc.set_memento(delta);
+
+    ASSERT_THAT(doc.text(), StrEq(text));
+}
+
+TEST_F(Document_DeltaMemento, CaseConversionWithoutChangesIsNoOp)
+{
+    doc = Document{"ABC"};
+
+    auto delta = doc.create_case_memento(Document::LetterCase::upper);
+    doc.to_upper();
+    doc.set_memento(delta);
+
+    ASSERT_THAT(doc.text(), StrEq("ABC"));
+}
+
+//-----------------------------------------------------------------
+
+struct Document_FindReplace : Test
+{
+    Document doc{"the cat sat on the mat"};
+
+    // document stored in many pieces - one per element of chunks
+    static Document make_chunked_document(const std::vector<std::string>& chunks)
+    {
+        Document doc{std::make_unique<PieceTableStorage>("")};
+        for (auto it = chunks.rbegin(); it != chunks.rend(); ++it)
+            doc.replace(0, 0, *it);
+        return doc;
+    }
+};
+
+TEST_F(Document_FindReplace, FindsAllOccurrences)
+{
+    ASSERT_THAT(doc.find_all("at"), ElementsAre(5, 9, 20));
+    ASSERT_THAT(doc.find_all("the"), ElementsAre(0, 15));
+}
+
+TEST_F(Document_FindReplace, MissingOrEmptyPatternFindsNothing)
+{
+    ASSERT_THAT(doc.find_all("dog"), IsEmpty());
+    ASSERT_THAT(doc.find_all(""), IsEmpty());
+    ASSERT_THAT(doc.find_all("the cat sat on the mat!"), IsEmpty());
+}
+
+TEST_F(Document_FindReplace, OccurrencesDoNotOverlap)
+{
+    doc = Document{"aaaaa"};
+
+    ASSERT_THAT(doc.find_all("aa"), ElementsAre(0, 2));
+}
+
+TEST_F(Document_FindReplace, FindsOccurrencesSpanningChunks)
+{
+    doc = make_chunked_document({"the c", "a", "t s", "at on the m", "at"});
+
+    ASSERT_THAT(doc.find_all("cat sat"), ElementsAre(4));
+    ASSERT_THAT(doc.find_all("at"), ElementsAre(5, 9, 20));
+    ASSERT_THAT(doc.find_all("the cat sat on the mat"), ElementsAre(0));
+}
+
+TEST_F(Document_FindReplace, ChunkedDocumentGivesSameResultsAsContiguous)
+{
+    const std::string text = "abaababaabaaabab";
+    std::vector<std::string> chunks;
+    for (char c : text)
+        chunks.emplace_back(1, c);
+    Document chunked = make_chunked_document(chunks);
+    Document contiguous{text};
+
+    for (auto pattern : {"a", "ab", "aba", "abab", "baa", "aaab", "abaababaabaaabab"})
+        ASSERT_THAT(chunked.find_all(pattern), Eq(contiguous.find_all(pattern))) << pattern;
+}
+
+TEST_F(Document_FindReplace, ReplacesAllOccurrences)
+{
+    ASSERT_THAT(doc.replace_all("at", "og"), Eq(3));
+    ASSERT_THAT(doc.text(), StrEq("the cog sog on the mog"));
+}
+
+TEST_F(Document_FindReplace, ReplacesMatchesFoundBefore)
+{
+    std::pmr::monotonic_buffer_resource resource;
+    const auto matches = doc.find_all("at", std::pmr::polymorphic_allocator<size_t>{&resource});
+
+    ASSERT_THAT(doc.replace_matches(matches, 2, "og"), Eq(3));
+    ASSERT_THAT(doc.text(), StrEq("the cog sog on the mog"));
+}
+
+TEST_F(Document_FindReplace, ReplacementCanChangeLength)
+{
+    doc.replace_all("the", "a");
+    ASSERT_THAT(doc.text(), StrEq("a cat sat on a mat"));
+
+    doc.replace_all("a", "");
+    ASSERT_THAT(doc.text(), StrEq(" ct st on  mt"));
+}
+
+TEST_F(Document_FindReplace, ReplacesOccurrencesSpanningChunks)
+{
+    doc = make_chunked_document({"the c", "a", "t s", "at on the m", "at"});
+
+    ASSERT_THAT(doc.replace_all("at", "ow"), Eq(3));
+    ASSERT_THAT(doc.text(), StrEq("the cow sow on the mow"));
+}
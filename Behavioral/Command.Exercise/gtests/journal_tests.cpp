@@ -0,0 +1,295 @@
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "command.hpp"
+#include "journal.hpp"
+#include "mocks/mock_console.hpp"
+
+using namespace ::testing;
+
+struct JournalTests : Test
+{
+    const std::string journal_path = ::testing::TempDir() + "command_journal.bin";
+
+    void SetUp() override
+    {
+        std::remove(journal_path.c_str());
+    }
+
+    void TearDown() override
+    {
+        std::remove(journal_path.c_str());
+        std::remove((journal_path + ".tmp").c_str());
+    }
+
+    std::string recovered_text() const
+    {
+        StringStorage storage;
+        CommandJournal::replay(journal_path, storage);
+
+        Document doc{std::make_unique<StringStorage>(storage)};
+        return doc.text();
+    }
+
+    uint64_t file_size() const
+    {
+        std::ifstream file{journal_path, std::ios::binary | std::ios::ate};
+        return static_cast<uint64_t>(file.tellg());
+    }
+};
+
+TEST_F(JournalTests, EditsAreRecoveredFromJournal)
+{
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+
+        doc.add_text("abc def");
+        doc.replace(3, 1, "_");
+        doc.to_upper();
+    }
+
+    ASSERT_THAT(recovered_text(), StrEq("ABC_DEF"));
+}
+
+TEST_F(JournalTests, EffectsOfUndoneCommandsAreRecovered)
+{
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        CommandHistory history;
+        NiceMock<MockConsole> console;
+        ON_CALL(console, get_line()).WillByDefault(Return("abc"));
+
+        AddTextCmd{doc, console, history}.execute();
+        ToUpperCmd{doc, history}.execute();
+        UndoCmd{console, history}.execute();
+    }
+
+    ASSERT_THAT(recovered_text(), StrEq("abc"));
+}
+
+TEST_F(JournalTests, RecoveredDocumentContinuesJournal)
+{
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        doc.add_text("abc");
+    }
+
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        ASSERT_THAT(doc.text(), StrEq("abc"));
+
+        doc.add_text("def");
+    }
+
+    ASSERT_THAT(recovered_text(), StrEq("abcdef"));
+}
+
+TEST_F(JournalTests, RecordsAreWrittenInGroupCommits)
+{
+    JournalOptions options;
+    options.group_commit_bytes = 1 << 20;
+    options.group_commit_interval = std::chrono::hours(1);
+
+    CommandJournal journal{journal_path, options};
+    Document doc{journal.recover()};
+    const uint64_t initial_size = file_size();
+
+    doc.add_text("abc");
+    doc.add_text("def");
+    ASSERT_THAT(file_size(), Eq(initial_size));
+    ASSERT_THAT(journal.pending_bytes(), Gt(0u));
+
+    journal.commit();
+    ASSERT_THAT(file_size(), Gt(initial_size));
+    ASSERT_THAT(journal.pending_bytes(), Eq(0u));
+}
+
+TEST_F(JournalTests, PendingRecordsAreCommittedAfterIntervalWithoutFurtherEdits)
+{
+    JournalOptions options;
+    options.group_commit_interval = std::chrono::milliseconds(20);
+
+    CommandJournal journal{journal_path, options};
+    Document doc{journal.recover()};
+    const uint64_t initial_size = journal.committed_bytes();
+
+    doc.add_text("abc");
+
+    // committed bytes are counted when the record is synced
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (journal.committed_bytes() == initial_size && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    ASSERT_THAT(journal.pending_bytes(), Eq(0u));
+    ASSERT_THAT(file_size(), Eq(journal.committed_bytes()));
+    ASSERT_THAT(recovered_text(), StrEq("abc"));
+}
+
+TEST_F(JournalTests, CheckpointReplacesJournalWithSnapshot)
+{
+    CommandJournal journal{journal_path};
+    Document doc{journal.recover()};
+    journal.attach(doc);
+
+    for (int i = 0; i < 100; ++i)
+        doc.add_text("abc");
+    doc.to_upper();
+    journal.commit();
+    const uint64_t size_before = file_size();
+
+    journal.checkpoint();
+
+    ASSERT_THAT(file_size(), Lt(size_before));
+    ASSERT_THAT(recovered_text(), StrEq(doc.text()));
+}
+
+TEST_F(JournalTests, SnapshotIsTakenWhenIntervalIsExceeded)
+{
+    JournalOptions options;
+    options.snapshot_interval_bytes = 4096;
+
+    CommandJournal journal{journal_path, options};
+    Document doc{journal.recover()};
+    journal.attach(doc);
+
+    for (int i = 0; i < 1000; ++i)
+        doc.add_text("0123456789");
+    journal.commit();
+
+    ASSERT_THAT(file_size(), Lt(2 * doc.length()));
+    ASSERT_THAT(recovered_text(), StrEq(doc.text()));
+}
+
+TEST_F(JournalTests, FailedSnapshotDoesNotThrowFromEditAndIsReportedByCommit)
+{
+    JournalOptions options;
+    options.snapshot_interval_bytes = 16;
+
+    CommandJournal journal{journal_path, options};
+    Document doc{journal.recover()};
+    journal.attach(doc);
+
+    // the temporary file of a snapshot cannot be created
+    std::filesystem::create_directory(journal_path + ".tmp");
+
+    ASSERT_NO_THROW(doc.add_text("longer than the snapshot interval"));
+    ASSERT_THAT(doc.text(), StrEq("longer than the snapshot interval"));
+
+    ASSERT_THROW(journal.commit(), std::runtime_error);
+    ASSERT_NO_THROW(journal.commit());
+}
+
+TEST_F(JournalTests, TornRecordAtTheEndIsIgnored)
+{
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        doc.add_text("abc");
+    }
+
+    {
+        std::ofstream file{journal_path, std::ios::binary | std::ios::app};
+        const char partial_record[] = {static_cast<char>(CommandJournal::RecordType::insert), 0, 0};
+        file.write(partial_record, sizeof(partial_record));
+    }
+
+    ASSERT_THAT(recovered_text(), StrEq("abc"));
+}
+
+TEST_F(JournalTests, ZeroFilledTailIsIgnored)
+{
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        doc.add_text("abc");
+    }
+
+    {
+        std::ofstream file{journal_path, std::ios::binary | std::ios::app};
+        const std::string zeros(4096, '\0');
+        file.write(zeros.data(), static_cast<std::streamsize>(zeros.size()));
+    }
+
+    ASSERT_THAT(recovered_text(), StrEq("abc"));
+}
+
+TEST_F(JournalTests, ReplayEndsOnRecordWithBadChecksum)
+{
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        doc.add_text("abc");
+        journal.commit();
+        doc.add_text("def");
+    }
+
+    {
+        // damages the payload of the last record - it still deserializes
+        std::fstream file{journal_path, std::ios::binary | std::ios::in | std::ios::out};
+        file.seekp(-1, std::ios::end);
+        file.put('x');
+    }
+
+    ASSERT_THAT(recovered_text(), StrEq("abc"));
+}
+
+TEST_F(JournalTests, DamagedTailIsCutOffWhenJournalIsRecovered)
+{
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        doc.add_text("abc");
+    }
+
+    const uint64_t intact_size = file_size();
+    {
+        std::ofstream file{journal_path, std::ios::binary | std::ios::app};
+        file << "garbage";
+    }
+
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        ASSERT_THAT(journal.committed_bytes(), Eq(intact_size));
+
+        doc.add_text("def");
+    }
+
+    ASSERT_THAT(recovered_text(), StrEq("abcdef"));
+}
+
+TEST_F(JournalTests, CorruptedJournalThrows)
+{
+    {
+        std::ofstream file{journal_path, std::ios::binary};
+        file << "not a journal";
+    }
+
+    StringStorage storage;
+    ASSERT_THROW(CommandJournal::replay(journal_path, storage), std::runtime_error);
+}
+
+TEST_F(JournalTests, CopiesOfJournaledDocumentAreNotJournaled)
+{
+    {
+        CommandJournal journal{journal_path};
+        Document doc{journal.recover()};
+        doc.add_text("abc");
+
+        Document copy = doc;
+        copy.add_text("def");
+    }
+
+    ASSERT_THAT(recovered_text(), StrEq("abc"));
+}
@@ -12,7 +12,9 @@ struct MockReversibleCommand : public ReversibleCommand
 {
     MOCK_METHOD(void, execute, (), (override));
     MOCK_METHOD(void, undo, (), (override));
-    MOCK_METHOD(std::unique_ptr<ReversibleCommand>, clone, (), (const, override));
+    MOCK_METHOD(void, redo, (), (override));
+    MOCK_METHOD(ReversibleCommandPtr, clone, (), (const, override));
+    MOCK_METHOD(size_t, footprint, (), (const, override));
 };
 
 #endif // MOCK_COMMAND_HPP
@@ -0,0 +1,127 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "document.hpp"
+#include "serializers.hpp"
+
+using namespace ::testing;
+
+struct BinarySerializerTests : Test
+{
+    std::string buffer;
+};
+
+TEST_F(BinarySerializerTests, RoundTripsValuesAndStrings)
+{
+    BinaryOutputSerializer out{buffer};
+    ASSERT_TRUE(out(42, 3.5, std::string{"text with spaces"}));
+
+    int number{};
+    double real{};
+    std::string text;
+    BinaryInputSerializer in{buffer};
+
+    ASSERT_TRUE(in(number, real, text));
+    ASSERT_THAT(number, Eq(42));
+    ASSERT_THAT(real, DoubleEq(3.5));
+    ASSERT_THAT(text, StrEq("text with spaces"));
+}
+
+TEST_F(BinarySerializerTests, StringIsLengthPrefixed)
+{
+    BinaryOutputSerializer out{buffer};
+    out(std::string_view{"abc"});
+
+    ASSERT_THAT(buffer.size(), Eq(sizeof(uint64_t) + 3));
+    ASSERT_THAT(buffer.substr(sizeof(uint64_t)), StrEq("abc"));
+}
+
+TEST_F(BinarySerializerTests, StringViewPointsIntoBuffer)
+{
+    BinaryOutputSerializer out{buffer};
+    out(std::string{"abc"});
+
+    std::string_view text;
+    BinaryInputSerializer in{buffer};
+    in(text);
+
+    ASSERT_THAT(text, Eq("abc"));
+    ASSERT_THAT(text.data(), Eq(buffer.data() + sizeof(uint64_t)));
+}
+
+TEST_F(BinarySerializerTests, ReadingPastTheEndFails)
+{
+    BinaryOutputSerializer out{buffer};
+    out(1);
+
+    int first{}, second{};
+    BinaryInputSerializer in{buffer};
+
+    ASSERT_FALSE(in(first, second));
+    ASSERT_THAT(first, Eq(1));
+}
+
+TEST_F(BinarySerializerTests, WritesToVectorOfChars)
+{
+    std::vector<char> bytes;
+    BinaryOutputSerializer out{bytes};
+    out(std::string{"abc"});
+
+    std::string text;
+    BinaryInputSerializer in{bytes};
+    in(text);
+
+    ASSERT_THAT(text, StrEq("abc"));
+}
+
+TEST(ByteSpanTests, WritingPastCapacityFails)
+{
+    char memory[12];
+    ByteSpan span{memory};
+    BinaryOutputSerializer out{span};
+
+    ASSERT_TRUE(out(std::string{"abcd"}));
+    ASSERT_FALSE(out(std::string{"e"}));
+    ASSERT_THAT(span.size(), Eq(12));
+}
+
+struct Document_MementoSerializers : Test
+{
+    Document doc{"text with spaces"};
+};
+
+TEST_F(Document_MementoSerializers, BinaryMementoRestoresWhitespace)
+{
+    auto snapshot = doc.create_memento<BinaryOutputSerializer>();
+    doc.clear();
+    doc.set_memento<BinaryInputSerializer>(snapshot);
+
+    ASSERT_THAT(doc.text(), StrEq("text with spaces"));
+}
+
+TEST_F(Document_MementoSerializers, StreamMementoStillSupported)
+{
+    doc = Document{"abc"};
+
+    auto snapshot = doc.create_memento<StreamOutputSerializer>();
+    doc.clear();
+    doc.set_memento<StreamInputSerializer>(snapshot);
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Document_MementoSerializers, BinaryMementoIsWrittenFromAllChunks)
+{
+    Document chunked{std::make_unique<PieceTableStorage>("text spaces")};
+    chunked.replace(4, 0, " with");
+    chunked.add_text(" and more");
+
+    auto snapshot = chunked.create_memento<BinaryOutputSerializer>();
+    doc.set_memento<BinaryInputSerializer>(snapshot);
+
+    ASSERT_THAT(doc.text(), StrEq("text with spaces and more"));
+}
@@ -0,0 +1,212 @@
+#include <random>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "document.hpp"
+#include "text_storage.hpp"
+
+using namespace ::testing;
+
+namespace
+{
+    std::string content_of(const TextStorage& storage)
+    {
+        std::string result;
+        storage.for_each_chunk([&result](std::string_view chunk) { result.append(chunk); });
+
+        return result;
+    }
+}
+
+template <typename Storage>
+struct TextStorageTests : Test
+{
+    Storage storage{"abcdef"};
+};
+
+using StorageTypes = Types<StringStorage, PieceTableStorage>;
+TYPED_TEST_SUITE(TextStorageTests, StorageTypes);
+
+TYPED_TEST(TextStorageTests, ValueConstructed)
+{
+    ASSERT_THAT(content_of(this->storage), StrEq("abcdef"));
+    ASSERT_THAT(this->storage.length(), Eq(6));
+}
+
+TYPED_TEST(TextStorageTests, InsertsAtTheBeginning)
+{
+    this->storage.insert(0, "xy");
+
+    ASSERT_THAT(content_of(this->storage), StrEq("xyabcdef"));
+}
+
+TYPED_TEST(TextStorageTests, InsertsInTheMiddle)
+{
+    this->storage.insert(3, "xy");
+
+    ASSERT_THAT(content_of(this->storage), StrEq("abcxydef"));
+    ASSERT_THAT(this->storage.length(), Eq(8));
+}
+
+TYPED_TEST(TextStorageTests, InsertsAtTheEnd)
+{
+    this->storage.insert(6, "x");
+    this->storage.insert(7, "yz");
+
+    ASSERT_THAT(content_of(this->storage), StrEq("abcdefxyz"));
+}
+
+TYPED_TEST(TextStorageTests, ErasesRange)
+{
+    this->storage.erase(1, 3);
+
+    ASSERT_THAT(content_of(this->storage), StrEq("aef"));
+    ASSERT_THAT(this->storage.length(), Eq(3));
+}
+
+TYPED_TEST(TextStorageTests, ErasesToTheEndWhenCountExceedsLength)
+{
+    this->storage.erase(2, 100);
+
+    ASSERT_THAT(content_of(this->storage), StrEq("ab"));
+}
+
+TYPED_TEST(TextStorageTests, Clear)
+{
+    this->storage.clear();
+
+    ASSERT_THAT(content_of(this->storage), IsEmpty());
+    ASSERT_THAT(this->storage.length(), Eq(0));
+}
+
+TYPED_TEST(TextStorageTests, TransformsCharsInPlace)
+{
+    this->storage.insert(3, "xy");
+    this->storage.transform_chunks([](char* chunk, size_t size) {
+        for (size_t i = 0; i < size; ++i)
+            chunk[i] = '-';
+    });
+
+    ASSERT_THAT(content_of(this->storage), StrEq("--------"));
+}
+
+TYPED_TEST(TextStorageTests, CloneIsIndependent)
+{
+    auto copy = this->storage.clone();
+    this->storage.insert(0, "xyz");
+
+    ASSERT_THAT(content_of(*copy), StrEq("abcdef"));
+}
+
+TYPED_TEST(TextStorageTests, RandomEditsMatchStdString)
+{
+    std::mt19937 rnd{665};
+    std::string expected = "abcdef";
+
+    for (int i = 0; i < 2000; ++i)
+    {
+        auto pos = std::uniform_int_distribution<size_t>{0, expected.size()}(rnd);
+
+        if (rnd() % 3 == 0)
+        {
+            auto count = std::uniform_int_distribution<size_t>{0, 8}(rnd);
+            expected.erase(pos, count);
+            this->storage.erase(pos, count);
+        }
+        else
+        {
+            std::string text(1 + rnd() % 5, static_cast<char>('a' + rnd() % 26));
+            expected.insert(pos, text);
+            this->storage.insert(pos, text);
+        }
+    }
+
+    ASSERT_THAT(content_of(this->storage), StrEq(expected));
+    ASSERT_THAT(this->storage.length(), Eq(expected.size()));
+}
+
+TYPED_TEST(TextStorageTests, VisitsRangeOfChunks)
+{
+    this->storage.insert(2, "xy");
+    this->storage.insert(6, "z");
+
+    std::string range;
+    this->storage.for_each_chunk(1, 6, [&range](std::string_view chunk) { range.append(chunk); });
+
+    ASSERT_THAT(range, StrEq("bxycdz"));
+}
+
+TYPED_TEST(TextStorageTests, TransformsRangeOfChunks)
+{
+    this->storage.insert(3, "xy");
+    this->storage.transform_chunks(2, 3, [](char* chunk, size_t size) {
+        for (size_t i = 0; i < size; ++i)
+            chunk[i] = '-';
+    });
+
+    ASSERT_THAT(content_of(this->storage), StrEq("ab---def"));
+}
+
+struct PieceTableStorage_Append : Test
+{
+    PieceTableStorage storage;
+};
+
+TEST_F(PieceTableStorage_Append, ConsecutiveAppendsExtendLastPiece)
+{
+    for (int i = 0; i < 100; ++i)
+        storage.insert(storage.length(), "x");
+
+    ASSERT_THAT(storage.piece_count(), Eq(1));
+    ASSERT_THAT(storage.length(), Eq(100));
+}
+
+struct Document_PieceTableStorage : Test
+{
+    Document doc{std::make_unique<PieceTableStorage>("abc")};
+};
+
+TEST_F(Document_PieceTableStorage, SupportsDocumentApi)
+{
+    doc.add_text("def");
+    doc.replace(1, 2, "XYZ");
+    doc.to_upper();
+
+    ASSERT_THAT(doc.text(), StrEq("AXYZDEF"));
+}
+
+TEST_F(Document_PieceTableStorage, MementoRestoresThePreviousState)
+{
+    auto snapshot = doc.create_memento();
+    doc.clear();
+    doc.set_memento(snapshot);
+
+    ASSERT_THAT(doc.text(), StrEq("abc"));
+}
+
+TEST_F(Document_PieceTableStorage, CopyIsIndependent)
+{
+    Document copy = doc;
+    doc.add_text("def");
+
+    ASSERT_THAT(copy.text(), StrEq("abc"));
+}
+
+TEST_F(PieceTableStorage_Append, ErasedTextIsReclaimedFromAddBuffer)
+{
+    const std::string line(100, 'x');
+    storage.insert(0, "keep");
+
+    for (int i = 0; i < 10'000; ++i)
+    {
+        storage.insert(2, line);
+        storage.erase(2, line.size());
+    }
+
+    storage.insert(storage.length(), "!");
+
+    ASSERT_THAT(content_of(storage), StrEq("keep!"));
+    ASSERT_THAT(storage.added_bytes(), Le(2 * PieceTableStorage::compaction_min_bytes));
+}
@@ -1,26 +1,79 @@
 #include "application.hpp"
+#include "buffered_console.hpp"
 #include "command.hpp"
+#include "journal.hpp"
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
+#include <optional>
+#include <vector>
 
 using namespace std;
 
-int main()
+void register_commands(Application& app, Document& doc, Console& console, Clipboard& clipboard, CommandHistory& cmd_history)
 {
+    app.add_command("Print"s, std::make_shared<PrintCmd>(doc, console));
+    app.add_command("ToUpper"s, std::make_shared<ToUpperCmd>(doc, cmd_history));
+    app.add_command("Clear"s, std::make_shared<ClearCmd>(doc, cmd_history));
+    app.add_command("AddText"s, std::make_shared<AddTextCmd>(doc, console, cmd_history));
+    app.add_command("Paste"s, std::make_shared<PasteCmd>(doc, clipboard, cmd_history));
+    app.add_command("FindReplace"s, std::make_shared<FindReplaceCmd>(doc, console, cmd_history));
+    app.add_command("Undo"s, std::make_shared<UndoCmd>(console, cmd_history));
+    app.add_command("Redo"s, std::make_shared<RedoCmd>(console, cmd_history));
+
+    // TODO - register two commands: CopyCmd & ToLowerCmd
+}
+
+// usage: Command.Exercise [--journal journal_file] [--batch script_file]
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> args(argv + 1, argv + argc);
+
+    auto option = [&args](const std::string& name) -> std::optional<std::string> {
+        auto pos = std::find(args.begin(), args.end(), name);
+        if (pos == args.end() || std::next(pos) == args.end())
+            return std::nullopt;
+        return *std::next(pos);
+    };
+
+    // with a journal the document survives a crash - it is recovered on the next start
+    std::unique_ptr<CommandJournal> journal;
     Document doc;
-    Terminal terminal;
+    if (auto journal_path = option("--journal"))
+    {
+        journal = std::make_unique<CommandJournal>(*journal_path);
+        doc = Document{journal->recover()};
+        journal->attach(doc);
+    }
+
     SharedClipboard shared_clipboard;
     CommandHistory cmd_history;
 
-    Application app(terminal);
-    app.add_command("Print"s, std::make_shared<PrintCmd>(doc, terminal));
-    app.add_command("ToUpper"s, std::make_shared<ToUpperCmd>(doc, cmd_history));
-    app.add_command("Clear"s, std::make_shared<ClearCmd>(doc, cmd_history));
-    app.add_command("AddText"s, std::make_shared<AddTextCmd>(doc, terminal, cmd_history));
-    app.add_command("Paste"s, std::make_shared<PasteCmd>(doc, shared_clipboard, cmd_history));
-    app.add_command("Undo"s, std::make_shared<UndoCmd>(terminal, cmd_history));
+    if (auto script_path = option("--batch"))
+    {
+        std::ifstream script{*script_path};
+        if (!script)
+        {
+            std::cerr << "Script not opened: " << *script_path << std::endl;
+            return 1;
+        }
 
-    // TODO - register two commands: CopyCmd & ToLowerCmd
+        ScriptConsole console{script, std::cout};
+        cmd_history.set_coalescing(true);
+
+        Application app(console);
+        register_commands(app, doc, console, shared_clipboard, cmd_history);
+        app.run_batch(script);
+
+        return 0;
+    }
+
+    // stdin and stdout read and written in large blocks - fast when driven through pipes
+    BufferedConsole terminal;
+
+    Application app(terminal);
+    register_commands(app, doc, terminal, shared_clipboard, cmd_history);
 
     app.run();
 }
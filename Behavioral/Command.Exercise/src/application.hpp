@@ -1,16 +1,31 @@
 #ifndef APPLICATION_HPP
 #define APPLICATION_HPP
 
-#include <algorithm>
-#include <unordered_map>
+#include <chrono>
+#include <istream>
+#include <string>
 
+#include "case_conversion.hpp"
 #include "command.hpp"
+#include "command_registry.hpp"
 #include "console.hpp"
 
 namespace Messages
 {
     constexpr auto msg_unknown_cmd = "Unknown command: ";
     constexpr auto msg_prompt = "Enter a command: ";
+    constexpr auto msg_batch_summary = "Batch finished: ";
+};
+
+struct BatchStats
+{
+    size_t commands{};
+    double seconds{};
+
+    double commands_per_second() const
+    {
+        return seconds > 0.0 ? commands / seconds : 0.0;
+    }
 };
 
 class Application
@@ -18,7 +33,7 @@ class Application
     static const std::string cmd_exit;
 
     Console& console_;
-    std::unordered_map<std::string, CommandSharedPtr> cmds_;
+    CommandRegistry cmds_;
 
 public:
     Application(Console& console)
@@ -33,31 +48,67 @@ public:
             console_.print(Messages::msg_prompt);
 
             auto cmd = console_.get_line();
-            to_upper(cmd);
 
-            if (cmd == Commands::cmd_exit)
+            if (Details::equals_ignore_case(cmd, Commands::cmd_exit))
                 break;
 
-            if (auto pos = cmds_.find(cmd); pos != cmds_.end())
+            if (Command* command = cmds_.find(cmd))
             {
-                pos->second->execute();
+                command->execute();
             }
             else
             {
+                to_upper(cmd);
                 console_.print(Messages::msg_unknown_cmd + cmd);
             }
         }
     }
 
+    // Non-interactive mode - command names are read from a script, no prompts are shown.
+    // Commands reading their own input (e.g. AddText) should use a console reading
+    // from the same stream (ScriptConsole).
+    BatchStats run_batch(std::istream& script)
+    {
+        BatchStats stats;
+        const auto start = std::chrono::steady_clock::now();
+
+        std::string line;
+        while (std::getline(script, line))
+        {
+            if (Details::equals_ignore_case(line, Commands::cmd_exit))
+                break;
+
+            if (Command* command = cmds_.find(line))
+            {
+                command->execute();
+                ++stats.commands;
+            }
+            else
+            {
+                auto cmd = line;
+                to_upper(cmd);
+                console_.print(Messages::msg_unknown_cmd + cmd);
+            }
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        console_.print(Messages::msg_batch_summary + std::to_string(stats.commands) + " commands in "
+            + std::to_string(stats.seconds) + " s (" + std::to_string(stats.commands_per_second()) + " commands/sec)");
+        console_.flush();
+
+        return stats;
+    }
+
+    // command names are case-insensitive
     void add_command(std::string name, CommandSharedPtr cmd)
     {
-        to_upper(name);
-        cmds_.emplace(std::move(name), cmd);
+        cmds_.add(name, std::move(cmd));
     }
-public:
+
     void to_upper(std::string& text)
     {
-        std::transform(text.begin(), text.end(), text.begin(), [](auto c) { return std::toupper(c);});
+        CaseConversion::to_upper(text.data(), text.size());
     }
 };
 
@@ -0,0 +1,242 @@
+#include "buffered_console.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // every change of the output state is notified - a wait_for with this timeout is only repeated
+    constexpr std::chrono::seconds wait_timeout{1};
+
+    // platform layer - POSIX calls, on Windows their CRT counterparts
+#ifdef _WIN32
+    long read_some(int fd, char* data, size_t size)
+    {
+        return _read(fd, data, static_cast<unsigned>(size));
+    }
+
+    long write_some(int fd, const char* data, size_t size)
+    {
+        return _write(fd, data, static_cast<unsigned>(size));
+    }
+#else
+    long read_some(int fd, char* data, size_t size)
+    {
+        return static_cast<long>(::read(fd, data, size));
+    }
+
+    long write_some(int fd, const char* data, size_t size)
+    {
+        return static_cast<long>(::write(fd, data, size));
+    }
+#endif
+}
+
+BufferedConsole::BufferedConsole(int in_fd, int out_fd, BufferedConsoleOptions options)
+    : in_fd_{in_fd}
+    , out_fd_{out_fd}
+    , options_{options}
+    , read_buffer_(std::max<size_t>(options.read_buffer_size, 1))
+{
+    write_buffer_.reserve(options_.write_buffer_size);
+
+    if (options_.output_thread)
+    {
+        out_buffer_.reserve(options_.write_buffer_size);
+        out_thread_ = std::thread{[this] { run_output_thread(); }};
+    }
+}
+
+BufferedConsole::~BufferedConsole()
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+    }
+
+    if (out_thread_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lk{out_mtx_};
+            done_ = true;
+        }
+        out_cv_.notify_all();
+        out_thread_.join();
+    }
+}
+
+std::string BufferedConsole::get_line()
+{
+    std::string line;
+
+    while (true)
+    {
+        const char* begin = read_buffer_.data() + read_pos_;
+        const size_t available = read_end_ - read_pos_;
+
+        if (auto* end_of_line = static_cast<const char*>(std::memchr(begin, '\n', available)))
+        {
+            line.append(begin, end_of_line);
+            read_pos_ += static_cast<size_t>(end_of_line - begin) + 1;
+            break;
+        }
+
+        line.append(begin, available);
+        read_pos_ = read_end_ = 0;
+
+        if (!fill_read_buffer())
+            break;
+    }
+
+    return line;
+}
+
+void BufferedConsole::print(const std::string& line)
+{
+    write_buffer_ += line;
+    write_buffer_ += '\n';
+
+    if (write_buffer_.size() >= options_.write_buffer_size)
+        submit_output();
+}
+
+void BufferedConsole::flush()
+{
+    submit_output();
+
+    if (options_.output_thread)
+    {
+        std::unique_lock<std::mutex> lk{out_mtx_};
+        wait_for_output(lk);
+
+        if (std::exchange(out_failed_, false))
+            throw std::runtime_error("Writing console output failed");
+    }
+}
+
+bool BufferedConsole::fill_read_buffer()
+{
+    if (eof_)
+        return false;
+
+    // reading may block - the user has to see the output first (e.g. a prompt)
+    flush();
+
+    long count = 0;
+    do
+    {
+        count = read_some(in_fd_, read_buffer_.data(), read_buffer_.size());
+    } while (count < 0 && errno == EINTR);
+
+    if (count < 0)
+        throw std::runtime_error("Reading console input failed");
+
+    eof_ = (count == 0);
+    read_end_ = static_cast<size_t>(count);
+
+    return !eof_;
+}
+
+void BufferedConsole::submit_output()
+{
+    if (write_buffer_.empty())
+        return;
+
+    if (!options_.output_thread)
+    {
+        write_out(write_buffer_);
+        write_buffer_.clear();
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lk{out_mtx_};
+        wait_for_output(lk);
+
+        std::swap(write_buffer_, out_buffer_); // both buffers keep their capacity
+        out_pending_ = true;
+    }
+    out_cv_.notify_all();
+}
+
+void BufferedConsole::wait_for_output(std::unique_lock<std::mutex>& lk)
+{
+    wait_until(lk, [this] { return !out_pending_; });
+}
+
+template <typename Predicate>
+void BufferedConsole::wait_until(std::unique_lock<std::mutex>& lk, Predicate ready)
+{
+    while (!out_cv_.wait_for(lk, wait_timeout, ready))
+    {
+    }
+}
+
+void BufferedConsole::run_output_thread()
+{
+    std::unique_lock<std::mutex> lk{out_mtx_};
+
+    while (true)
+    {
+        wait_until(lk, [this] { return out_pending_ || done_; });
+
+        if (out_pending_)
+        {
+            lk.unlock();
+
+            bool failed = false;
+            try
+            {
+                write_out(out_buffer_);
+            }
+            catch (const std::runtime_error&)
+            {
+                failed = true;
+            }
+            out_buffer_.clear();
+
+            lk.lock();
+            out_pending_ = false;
+            out_failed_ = out_failed_ || failed;
+            out_cv_.notify_all();
+        }
+        else if (done_)
+        {
+            return;
+        }
+    }
+}
+
+void BufferedConsole::write_out(const std::string& data)
+{
+    const char* pos = data.data();
+    size_t size = data.size();
+
+    while (size > 0)
+    {
+        const long written = write_some(out_fd_, pos, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            throw std::runtime_error("Writing console output failed");
+        }
+
+        pos += written;
+        size -= static_cast<size_t>(written);
+    }
+}
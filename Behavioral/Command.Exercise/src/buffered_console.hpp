@@ -0,0 +1,73 @@
+#ifndef BUFFERED_CONSOLE_HPP
+#define BUFFERED_CONSOLE_HPP
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "console.hpp"
+
+struct BufferedConsoleOptions
+{
+    size_t read_buffer_size = 64 * 1024;
+    // printed lines are written together when the limit is reached
+    size_t write_buffer_size = 64 * 1024;
+    // full buffers are written by a separate thread - printing continues to a second buffer meanwhile
+    bool output_thread = false;
+};
+
+// Console reading and writing file descriptors (stdin and stdout by default) in large blocks.
+// Output is written when the write buffer is full, on flush(), and before reading blocks
+// for more input - a prompt is always visible to an interactive user.
+// Used instead of Terminal when the editor is driven through pipes.
+class BufferedConsole : public Console
+{
+public:
+    explicit BufferedConsole(int in_fd = 0, int out_fd = 1, BufferedConsoleOptions options = {});
+
+    BufferedConsole(const BufferedConsole&) = delete;
+    BufferedConsole& operator=(const BufferedConsole&) = delete;
+
+    ~BufferedConsole() override;
+
+    // returns an empty line at the end of input
+    std::string get_line() override;
+
+    void print(const std::string& line) override;
+
+    // returns when all printed lines are written
+    void flush() override;
+
+private:
+    int in_fd_;
+    int out_fd_;
+    BufferedConsoleOptions options_;
+
+    std::vector<char> read_buffer_;
+    size_t read_pos_{};
+    size_t read_end_{};
+    bool eof_{};
+
+    std::string write_buffer_;
+
+    // output thread - writes out_buffer_ while lines are printed to write_buffer_
+    std::string out_buffer_;
+    std::mutex out_mtx_;
+    std::condition_variable out_cv_;
+    bool out_pending_{}; // out_buffer_ holds lines not written yet
+    bool out_failed_{};
+    bool done_{};
+    std::thread out_thread_;
+
+    bool fill_read_buffer();
+    void submit_output();
+    void wait_for_output(std::unique_lock<std::mutex>& lk);
+    template <typename Predicate>
+    void wait_until(std::unique_lock<std::mutex>& lk, Predicate ready);
+    void run_output_thread();
+    void write_out(const std::string& data);
+};
+
+#endif // BUFFERED_CONSOLE_HPP
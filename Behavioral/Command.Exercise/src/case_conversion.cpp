@@ -0,0 +1,162 @@
+#include "case_conversion.hpp"
+
+#include <cctype>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#define CASE_CONVERSION_X86
+#include <immintrin.h>
+#endif
+
+#if defined(CASE_CONVERSION_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CASE_CONVERSION_AVX2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace
+{
+    // first and last letter of the converted range
+    struct LetterRange
+    {
+        char first;
+        char last;
+    };
+
+    constexpr LetterRange lower_letters{'a', 'z'};
+    constexpr LetterRange upper_letters{'A', 'Z'};
+
+    template <bool Upper>
+    void convert_scalar(char* text, size_t size)
+    {
+        for (size_t i = 0; i < size; ++i)
+        {
+            const auto uc = static_cast<unsigned char>(text[i]);
+            text[i] = static_cast<char>(Upper ? std::toupper(uc) : std::tolower(uc));
+        }
+    }
+
+#ifdef CASE_CONVERSION_X86
+    // ASCII letters differ only in bit 0x20 - it is flipped for chars in [range.first, range.last]
+    void convert_sse2(char* text, size_t size, LetterRange range, void (*fallback)(char*, size_t))
+    {
+        const __m128i before_first = _mm_set1_epi8(static_cast<char>(range.first - 1));
+        const __m128i after_last = _mm_set1_epi8(static_cast<char>(range.last + 1));
+        const __m128i case_bit = _mm_set1_epi8(0x20);
+
+        size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+
+            if (_mm_movemask_epi8(block) != 0)
+            {
+                fallback(text + i, 16);
+                continue;
+            }
+
+            const __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(block, before_first), _mm_cmplt_epi8(block, after_last));
+            block = _mm_xor_si128(block, _mm_and_si128(is_letter, case_bit));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(text + i), block);
+        }
+
+        fallback(text + i, size - i);
+    }
+#endif
+
+#ifdef CASE_CONVERSION_AVX2
+    TARGET_AVX2 void convert_avx2(char* text, size_t size, LetterRange range, void (*fallback)(char*, size_t))
+    {
+        const __m256i before_first = _mm256_set1_epi8(static_cast<char>(range.first - 1));
+        const __m256i last = _mm256_set1_epi8(range.last);
+        const __m256i case_bit = _mm256_set1_epi8(0x20);
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+
+            if (_mm256_movemask_epi8(block) != 0)
+            {
+                fallback(text + i, 32);
+                continue;
+            }
+
+            const __m256i is_letter = _mm256_andnot_si256(_mm256_cmpgt_epi8(block, last), _mm256_cmpgt_epi8(block, before_first));
+            block = _mm256_xor_si256(block, _mm256_and_si256(is_letter, case_bit));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(text + i), block);
+        }
+
+        convert_sse2(text + i, size - i, range, fallback);
+    }
+#endif
+
+    enum class Kernel
+    {
+        scalar,
+        sse2,
+        avx2
+    };
+
+    Kernel select_kernel()
+    {
+#if defined(CASE_CONVERSION_AVX2)
+        if (__builtin_cpu_supports("avx2"))
+            return Kernel::avx2;
+#endif
+#if defined(CASE_CONVERSION_X86)
+        return Kernel::sse2;
+#else
+        return Kernel::scalar;
+#endif
+    }
+
+    Kernel active_kernel()
+    {
+        static const Kernel kernel = select_kernel();
+        return kernel;
+    }
+
+    template <bool Upper>
+    void convert(char* text, size_t size)
+    {
+        [[maybe_unused]] const LetterRange range = Upper ? lower_letters : upper_letters;
+
+        switch (active_kernel())
+        {
+#ifdef CASE_CONVERSION_AVX2
+        case Kernel::avx2:
+            convert_avx2(text, size, range, &convert_scalar<Upper>);
+            return;
+#endif
+#ifdef CASE_CONVERSION_X86
+        case Kernel::sse2:
+            convert_sse2(text, size, range, &convert_scalar<Upper>);
+            return;
+#endif
+        default:
+            convert_scalar<Upper>(text, size);
+        }
+    }
+}
+
+void CaseConversion::to_upper(char* text, size_t size)
+{
+    convert<true>(text, size);
+}
+
+void CaseConversion::to_lower(char* text, size_t size)
+{
+    convert<false>(text, size);
+}
+
+const char* CaseConversion::kernel_name()
+{
+    switch (active_kernel())
+    {
+    case Kernel::avx2:
+        return "avx2";
+    case Kernel::sse2:
+        return "sse2";
+    default:
+        return "scalar";
+    }
+}
@@ -0,0 +1,19 @@
+#ifndef CASE_CONVERSION_HPP
+#define CASE_CONVERSION_HPP
+
+#include <cstddef>
+
+// In-place case conversion of a block of chars.
+// Runs of ASCII chars are converted with SIMD kernels (AVX2 or SSE2 - selected at runtime),
+// blocks containing non-ASCII bytes fall back to std::toupper/std::tolower,
+// so results are the same as converting char by char.
+namespace CaseConversion
+{
+    void to_upper(char* text, size_t size);
+    void to_lower(char* text, size_t size);
+
+    // name of the kernel selected for this CPU: "avx2", "sse2" or "scalar"
+    const char* kernel_name();
+}
+
+#endif // CASE_CONVERSION_HPP
@@ -1,8 +1,13 @@
 #ifndef CLIPBOARD_HPP
 #define CLIPBOARD_HPP
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
+
+using ClipboardSnapshot = std::shared_ptr<const std::string>;
 
 class Clipboard
 {
@@ -10,12 +15,29 @@ public:
     virtual std::string content() const = 0;
     virtual void set_content(const std::string& content) = 0;
     virtual ~Clipboard() = default;
+
+    // immutable view of the content - implementations may share it without copying
+    virtual ClipboardSnapshot snapshot() const
+    {
+        return std::make_shared<const std::string>(content());
+    }
 };
 
+// RCU-style clipboard - set_content() publishes a new immutable string,
+// readers take a reference to the current one without copying it.
+// A published snapshot stays valid for its readers after the content is replaced.
+//
+// Content is kept in two slots - readers copy the shared_ptr of the current one while
+// they are counted in its readers_ counter; a writer fills the other slot, switches
+// current_ and waits until readers of the previous slot leave before releasing it.
+// Readers take no locks and never wait for writers - they retry only if the slot
+// changed under them. Writers are serialized by a mutex.
 class SharedClipboard : public Clipboard
 {
-    std::string content_;
-    mutable std::mutex content_mtx_;
+    ClipboardSnapshot slots_[2] = {std::make_shared<const std::string>(), nullptr};
+    mutable std::atomic<size_t> readers_[2]{};
+    std::atomic<size_t> current_{0};
+    std::mutex writer_mutex_;
 
 public:
     Clipboard& instance()
@@ -27,16 +49,52 @@ public:
 
     std::string content() const override
     {
-        std::lock_guard<std::mutex> lk{content_mtx_};
-
-        return content_;
+        return *snapshot();
     }
 
     void set_content(const std::string& content) override
     {
-        std::lock_guard<std::mutex> lk{content_mtx_};
+        auto new_content = std::make_shared<const std::string>(content);
+
+        std::lock_guard lk{writer_mutex_};
+
+        const size_t previous = current_.load();
+        const size_t next = 1 - previous;
+
+        // readers of the next slot were released by the previous writer - only late readers
+        // that saw it current may still be leaving (they retry without reading the slot)
+        wait_for_readers(next);
+        slots_[next] = std::move(new_content);
+        current_.store(next);
+
+        wait_for_readers(previous);
+        slots_[previous].reset();
+    }
+
+    ClipboardSnapshot snapshot() const override
+    {
+        while (true)
+        {
+            const size_t slot = current_.load();
+            readers_[slot].fetch_add(1);
 
-        content_ = content;
+            // the slot may have been switched before the reader was counted
+            if (current_.load() == slot)
+            {
+                ClipboardSnapshot content = slots_[slot];
+                readers_[slot].fetch_sub(1, std::memory_order_release);
+                return content;
+            }
+
+            readers_[slot].fetch_sub(1, std::memory_order_release);
+        }
+    }
+
+private:
+    void wait_for_readers(size_t slot) const
+    {
+        while (readers_[slot].load() != 0)
+            std::this_thread::yield();
     }
 };
 
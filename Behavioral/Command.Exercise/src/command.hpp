@@ -4,8 +4,17 @@
 #include "clipboard.hpp"
 #include "console.hpp"
 #include "document.hpp"
+#include "spill_store.hpp"
+#include <cassert>
+#include <deque>
+#include <limits>
 #include <memory>
-#include <stack>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace Commands
 {
@@ -22,47 +31,385 @@ public:
 using CommandSharedPtr = std::shared_ptr<Command>;
 using CommandPtr = std::unique_ptr<Command>;
 
+class ReversibleCommand;
+
+// Deletes a command created with new or allocated from a memory resource
+struct CommandDeleter
+{
+    std::pmr::memory_resource* resource{}; // nullptr - created with new
+    size_t size{};
+    size_t alignment{};
+
+    CommandDeleter() = default;
+
+    CommandDeleter(std::pmr::memory_resource* resource, size_t size, size_t alignment)
+        : resource{resource}
+        , size{size}
+        , alignment{alignment}
+    {
+    }
+
+    // a std::unique_ptr<T> converts to ReversibleCommandPtr
+    template <typename T>
+    CommandDeleter(std::default_delete<T>)
+    {
+    }
+
+    void operator()(ReversibleCommand* cmd) const;
+};
+
+using ReversibleCommandPtr = std::unique_ptr<ReversibleCommand, CommandDeleter>;
+
 class ReversibleCommand : public Command
 {
 public:
     virtual void undo() = 0;
-    virtual std::unique_ptr<ReversibleCommand> clone() const = 0;
+    virtual void redo() = 0;
+    virtual ReversibleCommandPtr clone() const = 0;
+
+    // moves a command to memory allocated from resource - the state of this command is left unspecified
+    virtual ReversibleCommandPtr move_into(std::pmr::memory_resource& /*resource*/)
+    {
+        return clone();
+    }
+
+    // bytes of memory held by a command stored in a history
+    virtual size_t footprint() const = 0;
+
+    // called on the last command in a history with a command executed right after it;
+    // returning true means that undo of this command reverts both - next is not recorded
+    virtual bool merge(const ReversibleCommand& /*next*/)
+    {
+        return false;
+    }
+
+    // moves cold state to a store - it is restored by fault_in() before undo or redo
+    virtual void spill(SpillStore&) { }
+    virtual void fault_in(SpillStore&) { }
 };
 
-using ReversibleCommandPtr = std::unique_ptr<ReversibleCommand>;
+inline void CommandDeleter::operator()(ReversibleCommand* cmd) const
+{
+    if (!resource)
+    {
+        delete cmd;
+        return;
+    }
+
+    void* memory = dynamic_cast<void*>(cmd); // start of the most derived object
+    cmd->~ReversibleCommand();
+    resource->deallocate(memory, size, alignment);
+}
 
 template <typename Cmd, typename BaseCommand = ReversibleCommand>
 class CloneableCommand : public BaseCommand
 {
 public:
-    std::unique_ptr<ReversibleCommand> clone() const override
+    ReversibleCommandPtr clone() const override
     {
         return std::make_unique<Cmd>(static_cast<Cmd const&>(*this));
     }
+
+    ReversibleCommandPtr move_into(std::pmr::memory_resource& resource) override
+    {
+        void* memory = resource.allocate(sizeof(Cmd), alignof(Cmd));
+
+        try
+        {
+            Cmd* cmd = ::new (memory) Cmd(std::move(static_cast<Cmd&>(*this)));
+            return ReversibleCommandPtr{cmd, CommandDeleter{&resource, sizeof(Cmd), alignof(Cmd)}};
+        }
+        catch (...)
+        {
+            resource.deallocate(memory, sizeof(Cmd), alignof(Cmd));
+            throw;
+        }
+    }
+
+    size_t footprint() const override
+    {
+        return sizeof(Cmd);
+    }
 };
 
-class CommandHistory
+template <typename Memento>
+class SpillableMemento
 {
-    std::stack<ReversibleCommandPtr> history_;
+    // re-created on assignment - a memento keeps the memory resource it was created with
+    std::optional<Memento> memento_{std::in_place};
+    std::optional<SpillStore::Handle> handle_;
+    SpillStore* store_{}; // holds the spilled memento - it outlives commands of a history
 
 public:
+    SpillableMemento() = default;
+
+    // only mementos kept in memory are copied (commands are cloned before they are recorded)
+    SpillableMemento(const SpillableMemento& other)
+        : memento_{other.memento_}
+    {
+        assert(!other.handle_);
+    }
+
+    SpillableMemento(SpillableMemento&& other) noexcept
+        : memento_{std::move(other.memento_)}
+        , handle_{std::exchange(other.handle_, std::nullopt)}
+        , store_{other.store_}
+    {
+    }
+
+    SpillableMemento& operator=(const SpillableMemento&) = delete;
+
+    ~SpillableMemento()
+    {
+        release();
+    }
+
+    SpillableMemento& operator=(Memento memento)
+    {
+        memento_.emplace(std::move(memento));
+        release();
+
+        return *this;
+    }
+
+    Memento& get()
+    {
+        assert(!handle_);
+        return *memento_;
+    }
+
+    size_t footprint() const
+    {
+        return memento_->footprint();
+    }
+
+    void spill(SpillStore& store)
+    {
+        if (!handle_)
+        {
+            handle_ = store.write(*memento_);
+            store_ = &store;
+
+            Memento released{std::move(*memento_)}; // takes allocated memory, memento_ keeps its resource
+        }
+    }
+
+    void fault_in(SpillStore& store)
+    {
+        if (handle_)
+        {
+            store.read(*handle_, *memento_);
+            release();
+        }
+    }
+
+private:
+    // the range in the store is reused by later spills
+    void release()
+    {
+        if (handle_)
+        {
+            store_->release(*handle_);
+            handle_.reset();
+        }
+    }
+};
+
+// Undo & redo stacks with an optional memory budget. When the budget is exceeded
+// cold commands are spilled to a store (if one is given) and then the oldest ones are evicted.
+// The most recently executed command is always kept.
+// Recorded commands, their mementos and the stacks are allocated from a pool owned by the history,
+// so once the pool is warmed up executing and undoing commands does not touch the global heap.
+class CommandHistory
+{
+public:
+    static constexpr size_t unlimited = std::numeric_limits<size_t>::max();
+
+    CommandHistory() = default;
+
+    explicit CommandHistory(size_t byte_budget)
+        : byte_budget_{byte_budget}
+    {
+    }
+
+    CommandHistory(size_t byte_budget, const std::string& spill_file_path)
+        : byte_budget_{byte_budget}
+        , spill_store_{std::make_unique<SpillStore>(spill_file_path)}
+    {
+    }
+
+    // recording a new command discards undone commands
     void record_last_command(ReversibleCommandPtr cmd)
     {
-        history_.push(std::move(cmd));
+        while (!undone_.empty())
+            drop_front(undone_);
+
+        if (coalescing_ && !done_.empty() && done_.back().cmd->merge(*cmd))
+        {
+            Entry& last = done_.back();
+            footprint_ -= last.footprint;
+            last.footprint = last.cmd->footprint();
+            footprint_ += last.footprint;
+
+            enforce_budget();
+            return;
+        }
+
+        push(done_, std::move(cmd));
     }
 
-    ReversibleCommandPtr pop_last_command()
+    // consecutive commands are merged into one undo step when possible
+    void set_coalescing(bool enabled)
     {
+        coalescing_ = enabled;
+    }
 
-        if (history_.empty())
+    ReversibleCommandPtr pop_last_command()
+    {
+        if (done_.empty())
             throw std::out_of_range("Command history is empty");
-        auto last_cmd = std::move(history_.top());
-        history_.pop();
 
-        return last_cmd;
+        return pop(done_);
+    }
+
+    void record_undone_command(ReversibleCommandPtr cmd)
+    {
+        push(undone_, std::move(cmd));
+    }
+
+    ReversibleCommandPtr pop_undone_command()
+    {
+        if (undone_.empty())
+            throw std::out_of_range("No undone commands in history");
+
+        return pop(undone_);
+    }
+
+    void record_redone_command(ReversibleCommandPtr cmd)
+    {
+        push(done_, std::move(cmd));
+    }
+
+    size_t size() const
+    {
+        return done_.size();
+    }
+
+    size_t undone_size() const
+    {
+        return undone_.size();
+    }
+
+    size_t footprint() const
+    {
+        return footprint_;
+    }
+
+    size_t byte_budget() const
+    {
+        return byte_budget_;
+    }
+
+    uint64_t spill_file_size() const
+    {
+        return spill_store_ ? spill_store_->file_size() : 0;
+    }
+
+    // not synchronized - a history is used by one thread at a time
+    std::pmr::memory_resource& memory_resource()
+    {
+        return pool_;
+    }
+
+private:
+    struct Entry
+    {
+        ReversibleCommandPtr cmd;
+        size_t footprint;
+        bool spilled;
+    };
+
+    std::pmr::unsynchronized_pool_resource pool_; // outlives commands stored in the stacks
+    size_t byte_budget_{unlimited};
+    std::unique_ptr<SpillStore> spill_store_; // outlives mementos spilled by commands in the stacks
+
+    // back() is the most recent entry of both stacks
+    std::pmr::deque<Entry> done_{&pool_};
+    std::pmr::deque<Entry> undone_{&pool_};
+    size_t footprint_{};
+    bool coalescing_{false};
+
+    void push(std::pmr::deque<Entry>& entries, ReversibleCommandPtr cmd)
+    {
+        const size_t cmd_footprint = cmd->footprint();
+        entries.push_back(Entry{std::move(cmd), cmd_footprint, false});
+        footprint_ += cmd_footprint;
+
+        enforce_budget();
+    }
+
+    ReversibleCommandPtr pop(std::pmr::deque<Entry>& entries)
+    {
+        Entry entry = std::move(entries.back());
+        entries.pop_back();
+        footprint_ -= entry.footprint;
+
+        if (entry.spilled)
+            entry.cmd->fault_in(*spill_store_);
+
+        return std::move(entry.cmd);
+    }
+
+    void drop_front(std::pmr::deque<Entry>& entries)
+    {
+        footprint_ -= entries.front().footprint;
+        entries.pop_front();
+    }
+
+    void spill(Entry& entry)
+    {
+        if (entry.spilled)
+            return;
+
+        entry.cmd->spill(*spill_store_);
+        entry.spilled = true;
+
+        footprint_ -= entry.footprint;
+        entry.footprint = entry.cmd->footprint();
+        footprint_ += entry.footprint;
+    }
+
+    void enforce_budget()
+    {
+        if (footprint_ <= byte_budget_)
+            return;
+
+        if (spill_store_)
+        {
+            for (size_t i = 0; i + 1 < done_.size() && footprint_ > byte_budget_; ++i)
+                spill(done_[i]);
+
+            for (size_t i = 0; i < undone_.size() && footprint_ > byte_budget_; ++i)
+                spill(undone_[i]);
+        }
+
+        // undone commands furthest from the current state go first
+        while (footprint_ > byte_budget_)
+        {
+            if (!undone_.empty())
+                drop_front(undone_);
+            else if (done_.size() > 1)
+                drop_front(done_);
+            else
+                break;
+        }
     }
 };
 
+// A command object held by an application is a prototype - execute() moves its state into
+// a command recorded in the history, so the prototype is left moved-from after every execution.
+// Invariant: do_read_input() and do_save_state() set the whole state used by do_execute(), do_undo()
+// and do_redo(), so an execution never depends on what a previous one left in the prototype.
 template <typename CommandType, typename CommandBaseType = ReversibleCommand>
 class ReversibleCommandBase : public CloneableCommand<CommandType, CommandBaseType>
 {
@@ -74,11 +421,13 @@ public:
     {
     }
 
+    // the executed command is moved to the history - this command is left moved-from
     void execute() final override
     {
+        do_read_input();
         do_save_state();
-        history_.record_last_command(this->clone());
         do_execute();
+        history_.record_last_command(this->move_into(history_.memory_resource()));
     }
 
     void undo() final override
@@ -86,10 +435,30 @@ public:
         do_undo();
     }
 
+    void redo() final override
+    {
+        do_redo();
+    }
+
 protected:
+    // mementos are allocated from the memory of the history
+    std::pmr::memory_resource* memory_resource() const
+    {
+        return &history_.memory_resource();
+    }
+
+    // commands asking a user for input do it here - saving state makes no console I/O
+    virtual void do_read_input() { }
+
     virtual void do_save_state() = 0;
     virtual void do_execute() = 0;
     virtual void do_undo() = 0;
+
+    // by default a command is executed again on a document restored by undo
+    virtual void do_redo()
+    {
+        do_execute();
+    }
 };
 
 //--------------------------------------------------------------------------------
@@ -105,7 +474,14 @@ public:
 
     void execute() override
     {
-        console_.print("[" + doc_.text() + "]");
+        std::string line;
+        line.reserve(doc_.length() + 2);
+
+        line += "[";
+        doc_.for_each_chunk([&line](std::string_view chunk) { line.append(chunk); });
+        line += "]";
+
+        console_.print(line);
     }
 
 private:
@@ -127,7 +503,7 @@ public:
 protected:
     void do_save_state() override
     {
-        memento_ = doc_.create_memento();
+        memento_ = doc_.create_delta_memento(0, doc_.length(), memory_resource());
     }
 
     void do_execute() override
@@ -137,12 +513,36 @@ protected:
 
     void do_undo() override
     {
-        doc_.set_memento(memento_);
+        doc_.set_memento(memento_.get());
+    }
+
+public:
+    size_t footprint() const override
+    {
+        return sizeof(*this) + memento_.footprint();
+    }
+
+    // clearing an already cleared document changes nothing
+    bool merge(const ReversibleCommand& next) override
+    {
+        auto* next_cmd = dynamic_cast<const ClearCmd*>(&next);
+
+        return next_cmd != nullptr && &next_cmd->doc_ == &doc_;
+    }
+
+    void spill(SpillStore& store) override
+    {
+        memento_.spill(store);
+    }
+
+    void fault_in(SpillStore& store) override
+    {
+        memento_.fault_in(store);
     }
 
 private:
     Document& doc_;
-    Document::Memento memento_;
+    SpillableMemento<Document::DeltaMemento> memento_;
 };
 
 //--------------------------------------------------------------------------------
@@ -159,7 +559,7 @@ public:
 protected:
     void do_save_state() override
     {
-        memento_ = doc_.create_memento();
+        memento_ = doc_.create_case_memento(Document::LetterCase::upper, memory_resource());
     }
 
     void do_execute() override
@@ -169,17 +569,60 @@ protected:
 
     void do_undo() override
     {
-        doc_.set_memento(memento_);
+        doc_.set_memento(memento_.get());
+    }
+
+public:
+    size_t footprint() const override
+    {
+        return sizeof(*this) + memento_.footprint();
+    }
+
+    // conversion of an already converted document changes nothing
+    bool merge(const ReversibleCommand& next) override
+    {
+        auto* next_cmd = dynamic_cast<const ToUpperCmd*>(&next);
+
+        return next_cmd != nullptr && &next_cmd->doc_ == &doc_;
+    }
+
+    void spill(SpillStore& store) override
+    {
+        memento_.spill(store);
+    }
+
+    void fault_in(SpillStore& store) override
+    {
+        memento_.fault_in(store);
     }
 
 private:
     Document& doc_;
-    Document::Memento memento_;
+    SpillableMemento<Document::DeltaMemento> memento_;
+};
+
+//--------------------------------------------------------------------------------
+// Commands appending text at the end of a document - undo erases everything
+// from append_pos() to the end, so consecutive appends form one contiguous range
+class AppendTextCommand : public ReversibleCommand
+{
+public:
+    virtual const Document& document() const = 0;
+    virtual size_t append_pos() const = 0;
+
+    bool merge(const ReversibleCommand& next) override
+    {
+        auto* next_append = dynamic_cast<const AppendTextCommand*>(&next);
+
+        return next_append != nullptr
+            && &next_append->document() == &document()
+            && next_append->append_pos() >= append_pos();
+    }
 };
 
 //--------------------------------------------------------------------------------
 // Paste command
-class PasteCmd : public ReversibleCommandBase<PasteCmd>
+class PasteCmd : public ReversibleCommandBase<PasteCmd, AppendTextCommand>
 {
 public:
     PasteCmd(Document& doc, Clipboard& clipboard_, CommandHistory& history)
@@ -197,20 +640,54 @@ protected:
 
     void do_execute() override
     {
-        doc_.add_text(clipboard_.content());
+        doc_.add_text(*clipboard_.snapshot());
     }
 
     void do_undo() override
     {
         size_t count = doc_.length() - prev_length_;
+        redo_memento_ = doc_.create_delta_memento(prev_length_, count, memory_resource());
         doc_.replace(prev_length_, count, "");
     }
 
+    // clipboard could change since - pasted text is restored from memento
+    void do_redo() override
+    {
+        doc_.set_memento(redo_memento_.get());
+    }
+
+public:
+    size_t footprint() const override
+    {
+        return sizeof(*this) + redo_memento_.footprint();
+    }
+
+    const Document& document() const override
+    {
+        return doc_;
+    }
+
+    size_t append_pos() const override
+    {
+        return prev_length_;
+    }
+
+    void spill(SpillStore& store) override
+    {
+        redo_memento_.spill(store);
+    }
+
+    void fault_in(SpillStore& store) override
+    {
+        redo_memento_.fault_in(store);
+    }
+
 private:
     Document& doc_;
     Clipboard& clipboard_;
 
     size_t prev_length_{};
+    SpillableMemento<Document::DeltaMemento> redo_memento_;
 };
 
 //--------------------------------------------------------------------------------
@@ -230,6 +707,7 @@ public:
         {
             auto last_cmd = history_.pop_last_command();
             last_cmd->undo();
+            history_.record_undone_command(std::move(last_cmd));
         }
         catch (const std::out_of_range&)
         {
@@ -242,9 +720,39 @@ private:
     CommandHistory& history_;
 };
 
+//--------------------------------------------------------------------------------
+// Redo command
+class RedoCmd : public Command
+{
+public:
+    RedoCmd(Console& console, CommandHistory& history)
+        : console_{console}
+        , history_(history)
+    {
+    }
+
+    void execute() override
+    {
+        try
+        {
+            auto undone_cmd = history_.pop_undone_command();
+            undone_cmd->redo();
+            history_.record_redone_command(std::move(undone_cmd));
+        }
+        catch (const std::out_of_range&)
+        {
+            console_.print("No undone commands. Nothing to redo.");
+        }
+    }
+
+private:
+    Console& console_;
+    CommandHistory& history_;
+};
+
 //--------------------------------------------------------------------------------
 // AddText command
-class AddTextCmd : public ReversibleCommandBase<AddTextCmd>
+class AddTextCmd : public ReversibleCommandBase<AddTextCmd, AppendTextCommand>
 {
 public:
     AddTextCmd(Document& doc, Console& console, CommandHistory& history)
@@ -255,6 +763,12 @@ public:
     }
 
 protected:
+    void do_read_input() override
+    {
+        console_.print("Write text: ");
+        text_ = console_.get_line();
+    }
+
     void do_save_state() override
     {
         prev_length_ = doc_.length();
@@ -262,21 +776,130 @@ protected:
 
     void do_execute() override
     {
-        console_.print("Write text: ");
-        auto txt = console_.get_line();
-        doc_.add_text(txt);
+        doc_.add_text(text_);
     }
 
     void do_undo() override
     {
         auto count = doc_.length() - prev_length_;
+        redo_memento_ = doc_.create_delta_memento(prev_length_, count, memory_resource());
         doc_.replace(prev_length_, count, "");
     }
 
+    void do_redo() override
+    {
+        doc_.set_memento(redo_memento_.get());
+    }
+
+public:
+    size_t footprint() const override
+    {
+        return sizeof(*this) + text_.capacity() + redo_memento_.footprint();
+    }
+
+    const Document& document() const override
+    {
+        return doc_;
+    }
+
+    size_t append_pos() const override
+    {
+        return prev_length_;
+    }
+
+    // undo & redo do not use the typed text - it is released instead of being spilled
+    void spill(SpillStore& store) override
+    {
+        redo_memento_.spill(store);
+        std::string{}.swap(text_);
+    }
+
+    void fault_in(SpillStore& store) override
+    {
+        redo_memento_.fault_in(store);
+    }
+
 private:
     Document& doc_;
     Console& console_;
+    std::string text_;
     size_t prev_length_{};
+    SpillableMemento<Document::DeltaMemento> redo_memento_;
+};
+
+//--------------------------------------------------------------------------------
+// FindReplace command
+class FindReplaceCmd : public ReversibleCommandBase<FindReplaceCmd>
+{
+public:
+    FindReplaceCmd(Document& doc, Console& console, CommandHistory& history)
+        : ReversibleCommandBase{history}
+        , doc_{doc}
+        , console_{console}
+        , matches_{memory_resource()}
+    {
+    }
+
+protected:
+    void do_read_input() override
+    {
+        console_.print("Find: ");
+        pattern_ = console_.get_line();
+        console_.print("Replace with: ");
+        replacement_ = console_.get_line();
+    }
+
+    // matches are found once - execute & redo replace them without searching again;
+    // the memento covers only the region between the first and the last match
+    void do_save_state() override
+    {
+        matches_ = doc_.find_all(pattern_, matches_.get_allocator());
+        memento_ = matches_.empty()
+            ? doc_.create_delta_memento(0, 0, memory_resource())
+            : doc_.create_delta_memento(matches_.front(), matches_.back() + pattern_.size() - matches_.front(), memory_resource());
+    }
+
+    void do_execute() override
+    {
+        const size_t count = doc_.replace_matches(matches_, pattern_.size(), replacement_);
+        console_.print("Replaced: " + std::to_string(count));
+    }
+
+    void do_undo() override
+    {
+        doc_.set_memento(memento_.get());
+    }
+
+    // a document restored by undo contains the same matches
+    void do_redo() override
+    {
+        doc_.replace_matches(matches_, pattern_.size(), replacement_);
+    }
+
+public:
+    size_t footprint() const override
+    {
+        return sizeof(*this) + pattern_.capacity() + replacement_.capacity()
+            + matches_.capacity() * sizeof(size_t) + memento_.footprint();
+    }
+
+    void spill(SpillStore& store) override
+    {
+        memento_.spill(store);
+    }
+
+    void fault_in(SpillStore& store) override
+    {
+        memento_.fault_in(store);
+    }
+
+private:
+    Document& doc_;
+    Console& console_;
+    std::string pattern_;
+    std::string replacement_;
+    std::pmr::vector<size_t> matches_; // allocated from the memory of the history
+    SpillableMemento<Document::DeltaMemento> memento_;
 };
 
 //--------------------------------------------------------------------------------
@@ -0,0 +1,128 @@
+#ifndef COMMAND_REGISTRY_HPP
+#define COMMAND_REGISTRY_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "command.hpp"
+
+namespace Details
+{
+    constexpr char ascii_upper(char c)
+    {
+        return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+    }
+
+    constexpr bool equals_ignore_case(std::string_view lhs, std::string_view rhs)
+    {
+        if (lhs.size() != rhs.size())
+            return false;
+
+        for (size_t i = 0; i < lhs.size(); ++i)
+        {
+            if (ascii_upper(lhs[i]) != ascii_upper(rhs[i]))
+                return false;
+        }
+
+        return true;
+    }
+}
+
+// Case-insensitive map of command names. The hash table is rebuilt on every registration
+// with a seed chosen so that no two names collide (perfect hashing) - a lookup hashes
+// a std::string_view once, probes exactly one slot and never allocates.
+class CommandRegistry
+{
+    struct Entry
+    {
+        std::string name; // upper case
+        CommandSharedPtr cmd;
+    };
+
+    static constexpr uint32_t empty_slot = UINT32_MAX;
+
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> slots_{empty_slot}; // indexes of entries
+    uint64_t seed_{};
+
+public:
+    // returns false if a command with the same name is already registered
+    bool add(std::string_view name, CommandSharedPtr cmd)
+    {
+        if (find(name))
+            return false;
+
+        std::string upper_name(name);
+        for (auto& c : upper_name)
+            c = Details::ascii_upper(c);
+
+        entries_.push_back(Entry{std::move(upper_name), std::move(cmd)});
+        rebuild();
+
+        return true;
+    }
+
+    Command* find(std::string_view name) const
+    {
+        const uint32_t index = slots_[hash(name, seed_) & (slots_.size() - 1)];
+
+        if (index == empty_slot || !Details::equals_ignore_case(entries_[index].name, name))
+            return nullptr;
+
+        return entries_[index].cmd.get();
+    }
+
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+private:
+    static uint64_t hash(std::string_view name, uint64_t seed)
+    {
+        // FNV-1a over upper-cased chars
+        uint64_t h = 14695981039346656037ull ^ seed;
+        for (char c : name)
+        {
+            h ^= static_cast<unsigned char>(Details::ascii_upper(c));
+            h *= 1099511628211ull;
+        }
+
+        return h ^ (h >> 29);
+    }
+
+    void rebuild()
+    {
+        size_t table_size = 1;
+        while (table_size < 2 * entries_.size())
+            table_size *= 2;
+
+        for (uint64_t seed = 0;; ++seed)
+        {
+            // after many failed seeds the table gets bigger
+            if (seed > 0 && seed % 64 == 0)
+                table_size *= 2;
+
+            std::vector<uint32_t> slots(table_size, empty_slot);
+            bool collision = false;
+
+            for (uint32_t i = 0; i < entries_.size() && !collision; ++i)
+            {
+                uint32_t& slot = slots[hash(entries_[i].name, seed) & (table_size - 1)];
+                collision = (slot != empty_slot);
+                slot = i;
+            }
+
+            if (!collision)
+            {
+                slots_ = std::move(slots);
+                seed_ = seed;
+                return;
+            }
+        }
+    }
+};
+
+#endif // COMMAND_REGISTRY_HPP
@@ -9,6 +9,7 @@ class Console
 public:
     virtual std::string get_line() = 0;
     virtual void print(const std::string& line) = 0;
+    virtual void flush() { }
     virtual ~Console() = default;
 };
 
@@ -27,6 +28,64 @@ public:
     {
         std::cout << line << std::endl;
     }
+
+    void flush() override
+    {
+        std::cout.flush();
+    }
+};
+
+// Console for non-interactive runs - lines are read from a script,
+// output is collected in a buffer and written in large blocks
+class ScriptConsole : public Console
+{
+    std::istream& in_;
+    std::ostream& out_;
+    std::string buffer_;
+    size_t flush_threshold_;
+
+public:
+    static constexpr size_t default_flush_threshold = 64 * 1024;
+
+    ScriptConsole(std::istream& in, std::ostream& out, size_t flush_threshold = default_flush_threshold)
+        : in_{in}
+        , out_{out}
+        , flush_threshold_{flush_threshold}
+    {
+        buffer_.reserve(flush_threshold_);
+    }
+
+    ScriptConsole(const ScriptConsole&) = delete;
+    ScriptConsole& operator=(const ScriptConsole&) = delete;
+
+    ~ScriptConsole() override
+    {
+        flush();
+    }
+
+    std::string get_line() override
+    {
+        std::string line;
+        std::getline(in_, line);
+
+        return line;
+    }
+
+    void print(const std::string& line) override
+    {
+        buffer_ += line;
+        buffer_ += '\n';
+
+        if (buffer_.size() >= flush_threshold_)
+            flush();
+    }
+
+    void flush() override
+    {
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        out_.flush();
+        buffer_.clear();
+    }
 };
 
 #endif // CONSOLE_HPP
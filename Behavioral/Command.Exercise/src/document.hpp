@@ -1,16 +1,26 @@
 #ifndef DOCUMENT_HPP
 #define DOCUMENT_HPP
 
+#include "case_conversion.hpp"
 #include "serializers.hpp"
+#include "text_search.hpp"
+#include "text_storage.hpp"
 
 #include <algorithm>
 #include <cctype>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <vector>
 
 class Document
 {
-    std::string text_;
+    static constexpr size_t mask_word_bits = 64;
+
+    TextStoragePtr storage_;
 
 public:
     class Memento
@@ -19,59 +29,250 @@ public:
         std::string snapshot_;
 
         friend class Document;
+
+    public:
+        template <typename Archive>
+        bool serialize(Archive& archive)
+        {
+            return archive(snapshot_);
+        }
+    };
+
+    enum class LetterCase
+    {
+        upper,
+        lower
+    };
+
+    // records only the region of a document changed by an edit
+    class DeltaMemento
+    {
+    private:
+        size_t start_pos_{};
+        size_t count_{};
+        size_t doc_length_{};
+        std::pmr::string old_text_;
+        // set bits mark chars changed by a case conversion - used instead of old_text_
+        std::pmr::vector<uint64_t> changed_chars_;
+        LetterCase converted_to_{};
+
+        friend class Document;
+
+    public:
+        DeltaMemento() = default;
+
+        // memory of a memento is allocated from resource
+        explicit DeltaMemento(std::pmr::memory_resource* resource)
+            : old_text_{resource}
+            , changed_chars_{resource}
+        {
+        }
+
+        size_t footprint() const
+        {
+            return old_text_.capacity() + changed_chars_.capacity() * sizeof(uint64_t);
+        }
+
+        template <typename Archive>
+        bool serialize(Archive& archive)
+        {
+            return archive(start_pos_, count_, doc_length_, old_text_, changed_chars_, converted_to_);
+        }
     };
 
     Document()
-        : text_{}
+        : storage_{std::make_unique<StringStorage>()}
     {
     }
 
     Document(const std::string& text)
-        : text_{text}
+        : storage_{std::make_unique<StringStorage>(text)}
+    {
+    }
+
+    explicit Document(TextStoragePtr storage)
+        : storage_{std::move(storage)}
     {
     }
 
+    Document(const Document& other)
+        : storage_{other.storage_->clone()}
+    {
+    }
+
+    Document& operator=(const Document& other)
+    {
+        if (this != &other)
+            storage_ = other.storage_->clone();
+
+        return *this;
+    }
+
+    Document(Document&&) = default;
+    Document& operator=(Document&&) = default;
+
     std::string text() const
     {
-        return text_;
+        std::string result;
+        result.reserve(length());
+        for_each_chunk([&result](std::string_view chunk) { result.append(chunk); });
+
+        return result;
+    }
+
+    // non-copying access to the content of a document
+    void for_each_chunk(const TextStorage::ChunkReader& reader) const
+    {
+        storage_->for_each_chunk(reader);
     }
 
     size_t length() const
     {
-        return text_.size();
+        return storage_->length();
     }
 
     void add_text(const std::string& txt)
     {
-        text_ += txt;
+        storage_->insert(storage_->length(), txt);
     }
 
     void to_upper()
     {
-        std::transform(text_.begin(), text_.end(), text_.begin(), [](auto c) { return std::toupper(c); });
+        storage_->transform_chunks([](char* chunk, size_t size) {
+            CaseConversion::to_upper(chunk, size);
+        });
     }
 
     void to_lower()
     {
-        std::transform(text_.begin(), text_.end(), text_.begin(), [](auto c) { return std::tolower(c); });
+        storage_->transform_chunks([](char* chunk, size_t size) {
+            CaseConversion::to_lower(chunk, size);
+        });
     }
 
     void clear()
     {
-        text_.clear();
+        storage_->clear();
+    }
+
+    // positions of non-overlapping occurrences of pattern (leftmost first);
+    // matches spanning chunks of a storage are found without copying the document
+    template <typename Allocator = std::allocator<size_t>>
+    std::vector<size_t, Allocator> find_all(std::string_view pattern, const Allocator& allocator = Allocator{}) const
+    {
+        std::vector<size_t, Allocator> matches(allocator);
+        if (pattern.empty())
+            return matches;
+
+        const size_t m = pattern.size();
+        std::string carry; // last m - 1 chars preceding a chunk
+        std::string window; // carry followed by first m - 1 chars of a chunk - reused for all chunks
+        size_t chunk_pos = 0;
+        size_t next_pos = 0; // matches do not overlap - no match can start before next_pos
+        carry.reserve(m - 1);
+        window.reserve(2 * (m - 1));
+
+        auto scan = [&](std::string_view text, size_t text_pos) {
+            size_t from = next_pos > text_pos ? next_pos - text_pos : 0;
+            for (size_t found; (found = TextSearch::find(text, pattern, from)) != TextSearch::npos; from = found + m)
+            {
+                matches.push_back(text_pos + found);
+                next_pos = text_pos + found + m;
+            }
+        };
+
+        storage_->for_each_chunk([&](std::string_view chunk) {
+            // matches spanning the boundary with preceding chunks
+            window.assign(carry);
+            window.append(chunk.substr(0, m - 1));
+            scan(window, chunk_pos - carry.size());
+
+            scan(chunk, chunk_pos);
+
+            const std::string_view tail = chunk.size() >= m - 1 ? chunk : std::string_view{window};
+            carry.assign(tail.substr(tail.size() - std::min(tail.size(), m - 1)));
+            chunk_pos += chunk.size();
+        });
+
+        return matches;
+    }
+
+    // replaces all non-overlapping occurrences of pattern - the changed region is rebuilt
+    // in one pass and written with a single replace; returns a number of replacements
+    size_t replace_all(std::string_view pattern, std::string_view replacement)
+    {
+        return replace_matches(find_all(pattern), pattern.size(), replacement);
+    }
+
+    // replaces matches of length m found by find_all() in the current content - no search is made
+    template <typename Matches>
+    size_t replace_matches(const Matches& matches, size_t m, std::string_view replacement)
+    {
+        if (matches.empty())
+            return 0;
+
+        const size_t region_pos = matches.front();
+        const size_t region_count = matches.back() + m - region_pos;
+
+        std::string region;
+        region.reserve(region_count - matches.size() * m + matches.size() * replacement.size());
+
+        size_t pos = region_pos;
+        size_t next_match = 0;
+        storage_->for_each_chunk(region_pos, region_count, [&](std::string_view chunk) {
+            const size_t chunk_end = pos + chunk.size();
+
+            while (pos < chunk_end)
+            {
+                if (next_match < matches.size() && matches[next_match] <= pos)
+                {
+                    // the end of a match could be in one of the following chunks
+                    const size_t match_end = matches[next_match] + m;
+                    if (pos == matches[next_match])
+                        region.append(replacement);
+
+                    pos = std::min(match_end, chunk_end);
+                    if (pos == match_end)
+                        ++next_match;
+                }
+                else
+                {
+                    const size_t copy_end = next_match < matches.size() ? std::min(matches[next_match], chunk_end) : chunk_end;
+                    region.append(chunk.substr(pos + chunk.size() - chunk_end, copy_end - pos));
+                    pos = copy_end;
+                }
+            }
+        });
+
+        replace(region_pos, region_count, region);
+
+        return matches.size();
     }
 
+    // Stream archives stay the default, so existing mementos can still be read - they stop
+    // at whitespace on reading; binary archives keep any text and must be chosen explicitly.
+    // The text is written chunk by chunk - no copy of the whole document is made.
     template <template <typename> class Serializer = StreamOutputSerializer>
     Memento create_memento() const
     {
-        std::stringstream stream;
+        Memento memento;
+
+        if constexpr (IsBinarySerializer<Serializer>::value)
         {
-            Serializer archive(stream);
-            archive(text_);
+            memento.snapshot_.reserve(sizeof(uint64_t) + length());
+            Serializer<std::string> archive(memento.snapshot_);
+            archive.write_chunks(length(), [this](const TextStorage::ChunkReader& write) { for_each_chunk(write); });
         }
+        else
+        {
+            std::stringstream stream;
+            {
+                Serializer archive(stream);
+                for_each_chunk([&archive](std::string_view chunk) { archive(chunk); });
+            }
 
-        Memento memento;
-        memento.snapshot_ = stream.str();
+            memento.snapshot_ = stream.str();
+        }
 
         return memento;
     }
@@ -79,14 +280,134 @@ public:
     template <template <typename> class Serializer = StreamInputSerializer>
     void set_memento(Memento& memento)
     {
-        std::stringstream stream{memento.snapshot_};
-        Serializer archive(stream);
-        archive(text_);
+        if constexpr (IsBinarySerializer<Serializer>::value)
+        {
+            Serializer<std::string> archive(memento.snapshot_);
+
+            std::string_view text;
+            archive(text);
+
+            storage_->clear();
+            storage_->insert(0, text);
+        }
+        else
+        {
+            std::stringstream stream{memento.snapshot_};
+            Serializer archive(stream);
+
+            std::string text;
+            archive(text);
+
+            storage_->clear();
+            storage_->insert(0, text);
+        }
+    }
+
+    // saves [start_pos, start_pos + count) - the region that is about to be edited
+    DeltaMemento create_delta_memento(size_t start_pos, size_t count,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+    {
+        DeltaMemento memento{resource};
+        memento.start_pos_ = std::min(start_pos, length());
+        memento.count_ = std::min(count, length() - memento.start_pos_);
+        memento.doc_length_ = length();
+
+        memento.old_text_.reserve(memento.count_);
+        storage_->for_each_chunk(memento.start_pos_, memento.count_, [&memento](std::string_view chunk) {
+            memento.old_text_.append(chunk);
+        });
+
+        return memento;
+    }
+
+    // saves only a bitmask of chars that will be changed by a conversion to letter_case
+    DeltaMemento create_case_memento(LetterCase letter_case,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const
+    {
+        std::pmr::vector<uint64_t> mask((length() + mask_word_bits - 1) / mask_word_bits, resource);
+        size_t first_changed = length();
+        size_t last_changed = 0;
+        bool reversible = true;
+        size_t index = 0;
+
+        auto scan = [&](std::string_view chunk) {
+            for (char c : chunk)
+            {
+                char converted = convert_case(c, letter_case);
+                if (converted != c)
+                {
+                    mask[index / mask_word_bits] |= uint64_t{1} << (index % mask_word_bits);
+                    first_changed = std::min(first_changed, index);
+                    last_changed = index;
+                    reversible = reversible && convert_case(converted, opposite(letter_case)) == c;
+                }
+                ++index;
+            }
+        };
+        // a single reference fits into the small buffer of std::function - no allocation
+        storage_->for_each_chunk([&scan](std::string_view chunk) { scan(chunk); });
+
+        if (first_changed == length())
+            return create_delta_memento(0, 0, resource);
+
+        if (!reversible)
+            return create_delta_memento(first_changed, last_changed - first_changed + 1, resource);
+
+        const size_t first_word = first_changed / mask_word_bits;
+        const size_t last_word = last_changed / mask_word_bits;
+
+        DeltaMemento memento{resource};
+        memento.start_pos_ = first_word * mask_word_bits;
+        memento.count_ = std::min(length(), (last_word + 1) * mask_word_bits) - memento.start_pos_;
+        memento.doc_length_ = length();
+        memento.changed_chars_.assign(mask.begin() + first_word, mask.begin() + last_word + 1);
+        memento.converted_to_ = letter_case;
+
+        return memento;
+    }
+
+    void set_memento(DeltaMemento& memento)
+    {
+        if (!memento.changed_chars_.empty())
+        {
+            const LetterCase restored_case = opposite(memento.converted_to_);
+            const auto& mask = memento.changed_chars_;
+            size_t index = 0;
+
+            auto restore = [&](char* chunk, size_t size) {
+                for (size_t i = 0; i < size; ++i, ++index)
+                {
+                    if ((mask[index / mask_word_bits] >> (index % mask_word_bits)) & 1)
+                        chunk[i] = convert_case(chunk[i], restored_case);
+                }
+            };
+            storage_->transform_chunks(memento.start_pos_, memento.count_, [&restore](char* chunk, size_t size) { restore(chunk, size); });
+        }
+        else
+        {
+            // the edited region could grow or shrink since the memento was created
+            const size_t current_count = memento.count_ + length() - memento.doc_length_;
+            replace(memento.start_pos_, current_count, memento.old_text_);
+        }
+    }
+
+    void replace(size_t start_pos, size_t count, std::string_view text)
+    {
+        storage_->erase(start_pos, count);
+        storage_->insert(start_pos, text);
+    }
+
+private:
+    static char convert_case(char c, LetterCase letter_case)
+    {
+        const auto uc = static_cast<unsigned char>(c);
+
+        return static_cast<char>(letter_case == LetterCase::upper ? std::toupper(uc) : std::tolower(uc));
     }
 
-    void replace(size_t start_pos, size_t count, const std::string& text)
+    static LetterCase opposite(LetterCase letter_case)
     {
-        text_.replace(start_pos, count, text);
+        return letter_case == LetterCase::upper ? LetterCase::lower : LetterCase::upper;
     }
 };
 
@@ -0,0 +1,246 @@
+#ifndef DOCUMENT_ENGINE_HPP
+#define DOCUMENT_ENGINE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "command.hpp"
+#include "thread_pool.hpp"
+
+struct DocumentStats
+{
+    size_t queue_depth{};
+    uint64_t executed{}; // including failed
+    uint64_t failed{}; // ended with an exception
+    std::chrono::nanoseconds total_latency{}; // from submission to the end of execution
+    std::chrono::nanoseconds max_latency{};
+
+    std::chrono::nanoseconds avg_latency() const
+    {
+        return executed > 0 ? total_latency / static_cast<int64_t>(executed) : std::chrono::nanoseconds{};
+    }
+};
+
+// Owns many documents with their command histories and executes submitted commands on a thread pool.
+// Commands of one document are executed one at a time in submission order (a strand),
+// commands of different documents run in parallel.
+class DocumentEngine
+{
+public:
+    using DocumentId = size_t;
+
+    // max number of commands executed by a strand before it yields a worker thread to other documents
+    static constexpr size_t strand_batch = 64;
+
+    explicit DocumentEngine(size_t thread_count = std::thread::hardware_concurrency(), size_t history_byte_budget = CommandHistory::unlimited)
+        : history_byte_budget_{history_byte_budget}
+        , pool_{thread_count}
+    {
+    }
+
+    DocumentEngine(const DocumentEngine&) = delete;
+    DocumentEngine& operator=(const DocumentEngine&) = delete;
+
+    ~DocumentEngine()
+    {
+        wait();
+    }
+
+    DocumentId add_document(const std::string& text = "")
+    {
+        std::unique_lock<std::shared_mutex> lk{sessions_mtx_};
+
+        sessions_.push_back(std::make_unique<Session>(text, history_byte_budget_));
+        return sessions_.size() - 1;
+    }
+
+    size_t document_count() const
+    {
+        std::shared_lock<std::shared_mutex> lk{sessions_mtx_};
+
+        return sessions_.size();
+    }
+
+    // Commands for a document are created with references returned by document() and history().
+    // Neither of them can be accessed outside of commands while commands of the document are pending.
+    Document& document(DocumentId id)
+    {
+        return session(id).document;
+    }
+
+    CommandHistory& history(DocumentId id)
+    {
+        return session(id).history;
+    }
+
+    void submit(DocumentId id, CommandPtr cmd)
+    {
+        Session& s = session(id);
+        ++in_flight_;
+
+        bool schedule = false;
+        {
+            std::lock_guard<std::mutex> lk{s.queue_mtx};
+            s.queue.push_back(PendingCommand{std::move(cmd), Clock::now()});
+            s.queue_depth.store(s.queue.size(), std::memory_order_relaxed);
+            schedule = !std::exchange(s.scheduled, true);
+        }
+
+        if (schedule)
+            pool_.submit([this, &s] { run_strand(s); });
+    }
+
+    // blocks until all submitted commands are executed
+    void wait()
+    {
+        while (!wait_for(std::chrono::seconds(1)))
+        {
+        }
+    }
+
+    // returns false if some commands are still pending after timeout
+    template <typename Rep, typename Period>
+    bool wait_for(const std::chrono::duration<Rep, Period>& timeout)
+    {
+        std::unique_lock<std::mutex> lk{idle_mtx_};
+        return idle_cv_.wait_for(lk, timeout, [this] { return in_flight_ == 0; });
+    }
+
+    DocumentStats stats(DocumentId id) const
+    {
+        const Session& s = session(id);
+
+        DocumentStats stats;
+        stats.queue_depth = s.queue_depth.load(std::memory_order_relaxed);
+        stats.executed = s.executed.load(std::memory_order_relaxed);
+        stats.failed = s.failed.load(std::memory_order_relaxed);
+        stats.total_latency = std::chrono::nanoseconds{s.total_latency_ns.load(std::memory_order_relaxed)};
+        stats.max_latency = std::chrono::nanoseconds{s.max_latency_ns.load(std::memory_order_relaxed)};
+
+        return stats;
+    }
+
+    size_t thread_count() const
+    {
+        return pool_.thread_count();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct PendingCommand
+    {
+        CommandPtr cmd;
+        Clock::time_point submitted;
+    };
+
+    struct Session
+    {
+        Document document;
+        CommandHistory history;
+
+        std::mutex queue_mtx;
+        std::deque<PendingCommand> queue;
+        bool scheduled{}; // a strand task is submitted to the pool or running
+
+        std::atomic<size_t> queue_depth{0};
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<int64_t> total_latency_ns{0};
+        std::atomic<int64_t> max_latency_ns{0};
+
+        Session(const std::string& text, size_t history_byte_budget)
+            : document{text}
+            , history{history_byte_budget}
+        {
+        }
+    };
+
+    size_t history_byte_budget_;
+
+    mutable std::shared_mutex sessions_mtx_;
+    std::vector<std::unique_ptr<Session>> sessions_;
+
+    std::atomic<size_t> in_flight_{0};
+    std::mutex idle_mtx_;
+    std::condition_variable idle_cv_;
+
+    WorkStealingPool pool_; // destroyed first - workers may still refer to sessions
+
+    Session& session(DocumentId id) const
+    {
+        std::shared_lock<std::shared_mutex> lk{sessions_mtx_};
+
+        if (id >= sessions_.size())
+            throw std::out_of_range("Unknown document id: " + std::to_string(id));
+
+        return *sessions_[id];
+    }
+
+    void run_strand(Session& s)
+    {
+        for (size_t i = 0; i < strand_batch; ++i)
+        {
+            PendingCommand pending;
+            {
+                std::lock_guard<std::mutex> lk{s.queue_mtx};
+
+                if (s.queue.empty())
+                {
+                    s.scheduled = false;
+                    return;
+                }
+
+                pending = std::move(s.queue.front());
+                s.queue.pop_front();
+                s.queue_depth.store(s.queue.size(), std::memory_order_relaxed);
+            }
+
+            execute(s, pending);
+        }
+
+        // more commands are queued - the strand continues as a new task, so other documents get a turn
+        pool_.defer([this, &s] { run_strand(s); });
+    }
+
+    void execute(Session& s, PendingCommand& pending)
+    {
+        try
+        {
+            pending.cmd->execute();
+        }
+        catch (...)
+        {
+            s.failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        s.executed.fetch_add(1, std::memory_order_relaxed);
+
+        const int64_t latency_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - pending.submitted).count();
+        s.total_latency_ns.fetch_add(latency_ns, std::memory_order_relaxed);
+
+        int64_t max_ns = s.max_latency_ns.load(std::memory_order_relaxed);
+        while (latency_ns > max_ns && !s.max_latency_ns.compare_exchange_weak(max_ns, latency_ns, std::memory_order_relaxed))
+        {
+        }
+
+        pending.cmd.reset();
+
+        if (--in_flight_ == 0)
+        {
+            std::lock_guard<std::mutex> lk{idle_mtx_};
+            idle_cv_.notify_all();
+        }
+    }
+};
+
+#endif // DOCUMENT_ENGINE_HPP
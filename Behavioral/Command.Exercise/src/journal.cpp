@@ -0,0 +1,545 @@
+#include "journal.hpp"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    constexpr std::string_view journal_magic{"CMDJRNL2"};
+
+    // how long the flusher sleeps without pending records - appending the first one wakes it earlier
+    constexpr std::chrono::seconds flusher_idle_wait{1};
+
+    // platform layer - POSIX calls, on Windows their CRT counterparts
+#ifdef _WIN32
+    int open_file(const std::string& path, bool truncate)
+    {
+        return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY | (truncate ? _O_TRUNC : 0), _S_IREAD | _S_IWRITE);
+    }
+
+    bool write_all(int fd, const char* data, size_t size)
+    {
+        return _write(fd, data, static_cast<unsigned>(size)) == static_cast<int>(size);
+    }
+
+    bool sync_file(int fd)
+    {
+        return _commit(fd) == 0;
+    }
+
+    void close_file(int fd)
+    {
+        _close(fd);
+    }
+
+    uint64_t file_size(int fd)
+    {
+        return static_cast<uint64_t>(_filelengthi64(fd));
+    }
+
+    bool truncate_file(int fd, uint64_t size)
+    {
+        return _chsize_s(fd, static_cast<__int64>(size)) == 0;
+    }
+
+    bool replace_file(const std::string& from, const std::string& to)
+    {
+        std::remove(to.c_str());
+        return std::rename(from.c_str(), to.c_str()) == 0;
+    }
+#else
+    int open_file(const std::string& path, bool truncate)
+    {
+        return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC | (truncate ? O_TRUNC : 0), 0644);
+    }
+
+    bool write_all(int fd, const char* data, size_t size)
+    {
+        while (size > 0)
+        {
+            const ssize_t written = ::write(fd, data, size);
+            if (written < 0)
+                return false;
+
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+
+        return true;
+    }
+
+    bool sync_file(int fd)
+    {
+        return ::fsync(fd) == 0;
+    }
+
+    void close_file(int fd)
+    {
+        ::close(fd);
+    }
+
+    uint64_t file_size(int fd)
+    {
+        struct stat info{};
+        return ::fstat(fd, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+    }
+
+    bool truncate_file(int fd, uint64_t size)
+    {
+        return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+    }
+
+    // atomic - a crash leaves either the old or the new file
+    bool replace_file(const std::string& from, const std::string& to)
+    {
+        return std::rename(from.c_str(), to.c_str()) == 0;
+    }
+#endif
+
+    [[noreturn]] void throw_corrupted(const std::string& file_path)
+    {
+        throw std::runtime_error("Journal is corrupted: " + file_path);
+    }
+
+    // CRC-32 (IEEE 802.3) - slicing-by-8: table[k] advances the CRC over a byte followed by k zero bytes
+    constexpr auto crc_tables = [] {
+        std::array<std::array<uint32_t, 256>, 8> tables{};
+        for (uint32_t i = 0; i < 256; ++i)
+        {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+            tables[0][i] = crc;
+        }
+
+        for (size_t k = 1; k < tables.size(); ++k)
+        {
+            for (uint32_t i = 0; i < 256; ++i)
+                tables[k][i] = tables[0][tables[k - 1][i] & 0xFF] ^ (tables[k - 1][i] >> 8);
+        }
+        return tables;
+    }();
+
+    uint32_t crc32(std::string_view data)
+    {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(data.data());
+        size_t size = data.size();
+        uint32_t crc = 0xFFFFFFFFu;
+
+        for (; size >= 8; bytes += 8, size -= 8)
+        {
+            const uint32_t low = crc ^ (bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24);
+            crc = crc_tables[7][low & 0xFF] ^ crc_tables[6][(low >> 8) & 0xFF] ^ crc_tables[5][(low >> 16) & 0xFF] ^ crc_tables[4][low >> 24]
+                ^ crc_tables[3][bytes[4]] ^ crc_tables[2][bytes[5]] ^ crc_tables[1][bytes[6]] ^ crc_tables[0][bytes[7]];
+        }
+
+        for (; size > 0; ++bytes, --size)
+            crc = crc_tables[0][(crc ^ *bytes) & 0xFF] ^ (crc >> 8);
+
+        return ~crc;
+    }
+
+    void store_u32(char* out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+            out[i] = static_cast<char>(value >> (8 * i));
+    }
+
+    uint32_t load_u32(const char* in)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(in[i])) << (8 * i);
+
+        return value;
+    }
+
+    // record frame: CRC-32 of the rest of the record, length of the body, body (type, pos, count, payload);
+    // the length is covered by the CRC - a zero-filled tail is not taken for an empty record
+    constexpr size_t record_header_size = 8;
+
+    size_t begin_record(std::string& out)
+    {
+        const size_t start = out.size();
+        out.append(record_header_size, '\0');
+        return start;
+    }
+
+    void end_record(std::string& out, size_t start)
+    {
+        const size_t length = out.size() - start - record_header_size;
+        if (length > UINT32_MAX)
+            throw std::length_error("Journal record is too long");
+
+        store_u32(&out[start + 4], static_cast<uint32_t>(length));
+        store_u32(&out[start], crc32(std::string_view{out}.substr(start + 4)));
+    }
+
+    // body of the next intact record - empty if the rest of the log is damaged
+    std::string_view next_record(std::string_view log)
+    {
+        if (log.size() < record_header_size)
+            return {};
+
+        const uint32_t length = load_u32(log.data() + 4);
+        if (length == 0 || length > log.size() - record_header_size)
+            return {};
+
+        if (crc32(log.substr(4, 4 + length)) != load_u32(log.data()))
+            return {};
+
+        return log.substr(record_header_size, length);
+    }
+}
+
+CommandJournal::CommandJournal(std::string file_path, JournalOptions options)
+    : file_path_{std::move(file_path)}
+    , options_{options}
+{
+    open_log();
+    bytes_since_snapshot_ = file_size_;
+
+    if (options_.group_commit_interval.count() > 0)
+        flusher_ = std::thread{[this] { run_flusher(); }};
+}
+
+CommandJournal::~CommandJournal()
+{
+    if (flusher_.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lk{mutex_};
+            stopping_ = true;
+        }
+        flush_cv_.notify_all();
+        flusher_.join();
+    }
+
+    try
+    {
+        write_pending();
+    }
+    catch (...)
+    {
+    }
+
+    close_log();
+}
+
+TextStoragePtr CommandJournal::recover(TextStoragePtr storage)
+{
+    const uint64_t intact_size = replay(file_path_, *storage);
+
+    // new records must follow the last intact one - a damaged tail is cut off
+    std::lock_guard<std::mutex> lk{io_mutex_};
+    if (intact_size >= journal_magic.size() && intact_size < file_size_)
+    {
+        if (!truncate_file(fd_, intact_size))
+            throw std::runtime_error("Journal not truncated: " + file_path_);
+
+        file_size_ = intact_size;
+    }
+
+    return std::make_unique<JournalingStorage>(std::move(storage), *this);
+}
+
+void CommandJournal::attach(const Document& doc)
+{
+    document_ = &doc;
+}
+
+uint64_t CommandJournal::replay(const std::string& file_path, TextStorage& storage)
+{
+    MappedFile file{file_path};
+    const std::string_view whole_log = file.data();
+
+    if (whole_log.empty())
+        return 0;
+
+    if (whole_log.substr(0, journal_magic.size()) != journal_magic)
+        throw_corrupted(file_path);
+
+    std::string_view log = whole_log.substr(journal_magic.size());
+    RecordType type{};
+    uint64_t pos{};
+    uint64_t count{};
+    std::string_view payload; // points into the mapped file
+
+    // a record torn by a crash fails its length or CRC check - replay ends on it
+    for (std::string_view record = next_record(log); !record.empty(); record = next_record(log))
+    {
+        log.remove_prefix(record_header_size + record.size());
+
+        // an intact record has to be complete
+        BinaryInputSerializer<std::string_view> archive{record};
+        if (!archive(type, pos, count, payload))
+            throw_corrupted(file_path);
+
+        const size_t length = storage.length();
+
+        switch (type)
+        {
+        case RecordType::snapshot:
+        {
+            // payload is Document::Memento::snapshot_ - a binary archive of a text
+            BinaryInputSerializer<std::string_view> snapshot_archive{payload};
+            std::string_view text;
+            if (!snapshot_archive(text))
+                throw_corrupted(file_path);
+
+            storage.clear();
+            storage.insert(0, text);
+            break;
+        }
+        case RecordType::insert:
+            if (pos > length)
+                throw_corrupted(file_path);
+            storage.insert(pos, payload);
+            break;
+        case RecordType::erase:
+            if (pos > length)
+                throw_corrupted(file_path);
+            storage.erase(pos, count);
+            break;
+        case RecordType::clear:
+            storage.clear();
+            break;
+        case RecordType::overwrite:
+        {
+            if (pos > length || count > length - pos || payload.size() != count)
+                throw_corrupted(file_path);
+
+            const char* source = payload.data();
+            storage.transform_chunks(pos, count, [&source](char* chunk, size_t size) {
+                std::memcpy(chunk, source, size);
+                source += size;
+            });
+            break;
+        }
+        default:
+            throw_corrupted(file_path);
+        }
+    }
+
+    return whole_log.size() - log.size();
+}
+
+void CommandJournal::append(RecordType type, uint64_t pos, uint64_t count, std::string_view payload)
+{
+    std::unique_lock<std::mutex> lk{mutex_};
+    const size_t start = begin_record(pending_);
+
+    BinaryOutputSerializer<std::string> archive{pending_};
+    archive(type, pos, count, payload);
+
+    end_record(pending_, start);
+    record_appended(lk, start);
+}
+
+void CommandJournal::append_range(RecordType type, uint64_t pos, uint64_t count, const TextStorage& source)
+{
+    std::unique_lock<std::mutex> lk{mutex_};
+    const size_t start = begin_record(pending_);
+
+    // same layout as a string payload - length prefix followed by chars
+    BinaryOutputSerializer<std::string> archive{pending_};
+    archive(type, pos, count, count);
+    pending_.reserve(pending_.size() + count);
+    source.for_each_chunk(pos, count, [this](std::string_view chunk) { pending_.append(chunk); });
+
+    end_record(pending_, start);
+    record_appended(lk, start);
+}
+
+void CommandJournal::record_appended(std::unique_lock<std::mutex>& lk, size_t record_start)
+{
+    bytes_since_snapshot_ += pending_.size() - record_start;
+
+    // the storage is already changed - failures are reported by the next commit
+    if (document_ && bytes_since_snapshot_ >= options_.snapshot_interval_bytes)
+    {
+        lk.unlock();
+        write_deferring_errors([this] { checkpoint(); });
+    }
+    else if (pending_.size() >= options_.group_commit_bytes || !flusher_.joinable())
+    {
+        lk.unlock();
+        write_deferring_errors([this] { write_pending(); });
+    }
+    else if (record_start == 0)
+    {
+        // the interval of the flusher starts with the first pending record
+        first_pending_ = std::chrono::steady_clock::now();
+        lk.unlock();
+        flush_cv_.notify_one();
+    }
+}
+
+template <typename Write>
+void CommandJournal::write_deferring_errors(Write write) noexcept
+{
+    try
+    {
+        write();
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lk{mutex_};
+        if (!flush_error_)
+            flush_error_ = std::current_exception();
+    }
+}
+
+void CommandJournal::commit()
+{
+    {
+        std::lock_guard<std::mutex> lk{mutex_};
+        if (flush_error_)
+            std::rethrow_exception(std::exchange(flush_error_, nullptr));
+    }
+
+    write_pending();
+}
+
+void CommandJournal::write_pending()
+{
+    std::lock_guard<std::mutex> io_lk{io_mutex_};
+
+    // records appended while the file is written wait in the other buffer
+    {
+        std::lock_guard<std::mutex> lk{mutex_};
+        writing_.swap(pending_);
+        pending_.clear();
+    }
+
+    if (writing_.empty())
+        return;
+
+    if (!write_all(fd_, writing_.data(), writing_.size()) || !sync_file(fd_))
+    {
+        // records are kept to be written by the next commit
+        std::lock_guard<std::mutex> lk{mutex_};
+        pending_.insert(0, writing_);
+        writing_.clear();
+        throw std::runtime_error("Writing to journal failed: " + file_path_);
+    }
+
+    file_size_ += writing_.size();
+    writing_.clear();
+}
+
+void CommandJournal::run_flusher()
+{
+    std::unique_lock<std::mutex> lk{mutex_};
+
+    while (!stopping_)
+    {
+        if (pending_.empty())
+        {
+            flush_cv_.wait_for(lk, flusher_idle_wait, [this] { return stopping_ || !pending_.empty(); });
+            continue;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto due = first_pending_ + options_.group_commit_interval;
+        if (now < due)
+        {
+            flush_cv_.wait_for(lk, due - now);
+            continue;
+        }
+
+        lk.unlock();
+        try
+        {
+            write_pending();
+            lk.lock();
+        }
+        catch (...)
+        {
+            lk.lock();
+            flush_error_ = std::current_exception();
+            first_pending_ = std::chrono::steady_clock::now(); // retried after the next interval
+        }
+    }
+}
+
+void CommandJournal::checkpoint()
+{
+    if (!document_)
+        throw std::logic_error("No document attached to journal: " + file_path_);
+
+    std::lock_guard<std::mutex> io_lk{io_mutex_};
+
+    // pending records are already reflected in the snapshot
+    {
+        std::lock_guard<std::mutex> lk{mutex_};
+        pending_.clear();
+    }
+
+    auto memento = document_->create_memento<BinaryOutputSerializer>();
+
+    // a new log starting with a snapshot record - memento is its payload
+    std::string snapshot{journal_magic};
+    const size_t start = begin_record(snapshot);
+    BinaryOutputSerializer<std::string> archive{snapshot};
+    archive(RecordType::snapshot, uint64_t{0}, uint64_t{0});
+    memento.serialize(archive);
+    end_record(snapshot, start);
+
+    const std::string temp_path = file_path_ + ".tmp";
+    const int temp_fd = open_file(temp_path, true);
+    if (temp_fd < 0)
+        throw std::runtime_error("Journal snapshot not created: " + temp_path);
+
+    const bool written = write_all(temp_fd, snapshot.data(), snapshot.size()) && sync_file(temp_fd);
+    close_file(temp_fd);
+
+    if (!written)
+        throw std::runtime_error("Writing journal snapshot failed: " + temp_path);
+
+    close_log();
+    if (!replace_file(temp_path, file_path_))
+        throw std::runtime_error("Journal snapshot not renamed: " + temp_path);
+    open_log();
+
+    std::lock_guard<std::mutex> lk{mutex_};
+    bytes_since_snapshot_ = 0;
+}
+
+void CommandJournal::open_log()
+{
+    fd_ = open_file(file_path_, false);
+    if (fd_ < 0)
+        throw std::runtime_error("Journal not opened: " + file_path_);
+
+    file_size_ = file_size(fd_);
+    if (file_size_ == 0)
+    {
+        if (!write_all(fd_, journal_magic.data(), journal_magic.size()) || !sync_file(fd_))
+            throw std::runtime_error("Writing to journal failed: " + file_path_);
+
+        file_size_ = journal_magic.size();
+    }
+}
+
+void CommandJournal::close_log()
+{
+    if (fd_ >= 0)
+    {
+        close_file(fd_);
+        fd_ = -1;
+    }
+}
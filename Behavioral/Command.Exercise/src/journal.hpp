@@ -0,0 +1,186 @@
+#ifndef JOURNAL_HPP
+#define JOURNAL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "document.hpp"
+#include "text_storage.hpp"
+
+struct JournalOptions
+{
+    // pending records are written and synced together when any of the limits is reached -
+    // a background thread commits records waiting longer than the interval, so at most
+    // the last interval of edits is lost in a crash (zero interval - every record is synced at once)
+    size_t group_commit_bytes = 1 << 20;
+    std::chrono::milliseconds group_commit_interval{10};
+    // a snapshot replaces the journal when records written since the last one exceed the limit
+    size_t snapshot_interval_bytes = 64 << 20;
+};
+
+// Write-ahead journal of edits made to a Document.
+// Every change of a document's storage (made by executed, undone or redone commands) is appended
+// to a binary log. After a crash the document is rebuilt by replaying the log (memory-mapped).
+// A snapshot created with Document::create_memento starts a new log - it bounds the replay time.
+// Records are framed with their length and a CRC-32 - replay ends on the first damaged record
+// (a tail torn or zero-filled by a crash).
+class CommandJournal
+{
+public:
+    enum class RecordType : uint8_t
+    {
+        snapshot = 1,
+        insert,
+        erase,
+        clear,
+        overwrite
+    };
+
+    explicit CommandJournal(std::string file_path, JournalOptions options = {});
+
+    CommandJournal(const CommandJournal&) = delete;
+    CommandJournal& operator=(const CommandJournal&) = delete;
+
+    ~CommandJournal();
+
+    // Replays the existing log into storage and returns it wrapped in a JournalingStorage.
+    // Used to create a journaled Document: Document doc{journal.recover()};
+    TextStoragePtr recover(TextStoragePtr storage = std::make_unique<StringStorage>());
+
+    // the document is used to create periodic snapshots
+    void attach(const Document& doc);
+
+    // applies records of a log to storage and returns the size of its intact part -
+    // records from the first damaged one to the end of the log are ignored
+    static uint64_t replay(const std::string& file_path, TextStorage& storage);
+
+    void append(RecordType type, uint64_t pos, uint64_t count, std::string_view payload = {});
+    // payload is copied from [pos, pos + count) of source
+    void append_range(RecordType type, uint64_t pos, uint64_t count, const TextStorage& source);
+
+    // writes and syncs pending records - rethrows a failure of an earlier write
+    void commit();
+
+    // replaces the log with a snapshot of the attached document
+    void checkpoint();
+
+    uint64_t committed_bytes() const
+    {
+        return file_size_;
+    }
+
+    size_t pending_bytes() const
+    {
+        std::lock_guard<std::mutex> lk{mutex_};
+        return pending_.size();
+    }
+
+private:
+    std::string file_path_;
+    JournalOptions options_;
+    const Document* document_{};
+
+    // log file - written by commits of the editing thread and of the flusher
+    std::mutex io_mutex_;
+    int fd_{-1};
+    std::atomic<uint64_t> file_size_{};
+    std::string writing_; // records being written
+
+    // records appended since the last commit
+    mutable std::mutex mutex_;
+    std::string pending_;
+    uint64_t bytes_since_snapshot_{};
+    std::chrono::steady_clock::time_point first_pending_; // when pending_ got its first record
+    std::exception_ptr flush_error_; // failure of a write after an edit - rethrown by commit()
+
+    std::condition_variable flush_cv_;
+    bool stopping_{};
+    std::thread flusher_;
+
+    void record_appended(std::unique_lock<std::mutex>& lk, size_t record_start);
+    template <typename Write>
+    void write_deferring_errors(Write write) noexcept;
+    void write_pending();
+    void run_flusher();
+    void open_log();
+    void close_log();
+};
+
+//--------------------------------------------------------------------------------
+// Storage decorator recording all changes in a journal.
+// A clone is not journaled - copies of a document are independent of the log.
+class JournalingStorage : public TextStorage
+{
+    TextStoragePtr storage_;
+    CommandJournal& journal_;
+
+public:
+    JournalingStorage(TextStoragePtr storage, CommandJournal& journal)
+        : storage_{std::move(storage)}
+        , journal_{journal}
+    {
+    }
+
+    size_t length() const override
+    {
+        return storage_->length();
+    }
+
+    void insert(size_t pos, std::string_view text) override
+    {
+        storage_->insert(pos, text);
+        journal_.append(CommandJournal::RecordType::insert, pos, text.size(), text);
+    }
+
+    void erase(size_t pos, size_t count) override
+    {
+        storage_->erase(pos, count);
+        journal_.append(CommandJournal::RecordType::erase, pos, count);
+    }
+
+    void clear() override
+    {
+        storage_->clear();
+        journal_.append(CommandJournal::RecordType::clear, 0, 0);
+    }
+
+    void for_each_chunk(const ChunkReader& reader) const override
+    {
+        storage_->for_each_chunk(reader);
+    }
+
+    void for_each_chunk(size_t pos, size_t count, const ChunkReader& reader) const override
+    {
+        storage_->for_each_chunk(pos, count, reader);
+    }
+
+    void transform_chunks(const ChunkWriter& writer) override
+    {
+        transform_chunks(0, storage_->length(), writer);
+    }
+
+    // chars changed in place are journaled as an overwrite of the whole range
+    void transform_chunks(size_t pos, size_t count, const ChunkWriter& writer) override
+    {
+        storage_->transform_chunks(pos, count, writer);
+
+        pos = std::min(pos, storage_->length());
+        count = std::min(count, storage_->length() - pos);
+        journal_.append_range(CommandJournal::RecordType::overwrite, pos, count, *storage_);
+    }
+
+    TextStoragePtr clone() const override
+    {
+        return storage_->clone();
+    }
+};
+
+#endif // JOURNAL_HPP
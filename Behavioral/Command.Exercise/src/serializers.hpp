@@ -1,6 +1,13 @@
 #ifndef SERIALIZERS_HPP
 #define SERIALIZERS_HPP
 
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
 template <typename TStream>
 class StreamOutputSerializer
 {
@@ -37,4 +44,225 @@ public:
     }
 };
 
-#endif
\ No newline at end of file
+//--------------------------------------------------------------------------------
+// Binary archives
+//
+// Trivially copyable values are stored as raw bytes (native byte order),
+// strings and vectors of such values as a uint64_t length prefix followed by raw bytes.
+
+// Fixed-capacity, caller-supplied memory block for BinaryOutputSerializer
+class ByteSpan
+{
+    char* data_;
+    size_t capacity_;
+    size_t size_{};
+
+public:
+    ByteSpan(char* data, size_t capacity)
+        : data_{data}
+        , capacity_{capacity}
+    { }
+
+    template <size_t N>
+    ByteSpan(char (&data)[N])
+        : ByteSpan{data, N}
+    { }
+
+    bool append(const char* bytes, size_t count)
+    {
+        if (count > capacity_ - size_)
+            return false;
+
+        std::memcpy(data_ + size_, bytes, count);
+        size_ += count;
+        return true;
+    }
+
+    const char* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    size_t capacity() const
+    {
+        return capacity_;
+    }
+};
+
+namespace Details
+{
+    template <typename TBuffer>
+    bool append_bytes(TBuffer& buffer, const char* bytes, size_t count)
+    {
+        buffer.insert(buffer.end(), bytes, bytes + count);
+        return true;
+    }
+
+    inline bool append_bytes(ByteSpan& buffer, const char* bytes, size_t count)
+    {
+        return buffer.append(bytes, count);
+    }
+
+    // std::string, std::pmr::string and std::string_view
+    template <typename T>
+    constexpr bool is_string_like_v = std::is_same_v<T, std::string_view>;
+
+    template <typename Allocator>
+    constexpr bool is_string_like_v<std::basic_string<char, std::char_traits<char>, Allocator>> = true;
+
+    template <typename T>
+    constexpr bool is_vector_of_values_v = false;
+
+    template <typename T, typename Allocator>
+    constexpr bool is_vector_of_values_v<std::vector<T, Allocator>> = std::is_trivially_copyable_v<T>;
+}
+
+template <typename TBuffer>
+class BinaryOutputSerializer
+{
+    TBuffer& buffer_;
+    bool failed_{};
+
+public:
+    BinaryOutputSerializer(TBuffer& buffer)
+        : buffer_{buffer}
+    { }
+
+    template <typename... TArgs>
+    bool operator()(const TArgs&... args)
+    {
+        (write(args), ...);
+        return !failed_;
+    }
+
+    // writes a string of size chars given in consecutive chunks - read back as one string;
+    // visit_chunks(writer) calls writer(std::string_view) for each chunk
+    template <typename ChunkVisitor>
+    bool write_chunks(uint64_t size, ChunkVisitor visit_chunks)
+    {
+        write(size);
+        visit_chunks([this](std::string_view chunk) { write_bytes(chunk.data(), chunk.size()); });
+        return !failed_;
+    }
+
+private:
+    template <typename T>
+    void write(const T& value)
+    {
+        if constexpr (Details::is_string_like_v<T>)
+        {
+            write(static_cast<uint64_t>(value.size()));
+            write_bytes(value.data(), value.size());
+        }
+        else if constexpr (Details::is_vector_of_values_v<T>)
+        {
+            write(static_cast<uint64_t>(value.size()));
+            write_bytes(reinterpret_cast<const char*>(value.data()), value.size() * sizeof(typename T::value_type));
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Type is not supported by a binary archive");
+            write_bytes(reinterpret_cast<const char*>(&value), sizeof(T));
+        }
+    }
+
+    void write_bytes(const char* bytes, size_t count)
+    {
+        if (!failed_)
+            failed_ = !Details::append_bytes(buffer_, bytes, count);
+    }
+};
+
+// Reads from any contiguous buffer (std::string, std::vector<char>, ByteSpan, std::string_view).
+// std::string_view arguments are set to point into the buffer - no chars are copied.
+template <typename TBuffer>
+class BinaryInputSerializer
+{
+    const char* data_;
+    size_t size_;
+    size_t pos_{};
+    bool failed_{};
+
+public:
+    BinaryInputSerializer(const TBuffer& buffer)
+        : data_{buffer.data()}
+        , size_{buffer.size()}
+    { }
+
+    template <typename... TArgs>
+    bool operator()(TArgs&... args)
+    {
+        (read(args), ...);
+        return !failed_;
+    }
+
+private:
+    template <typename T>
+    void read(T& value)
+    {
+        if constexpr (Details::is_string_like_v<T>)
+        {
+            uint64_t length{};
+            read(length);
+
+            if (const char* chars = read_bytes(length))
+                value = T(chars, length);
+        }
+        else if constexpr (Details::is_vector_of_values_v<T>)
+        {
+            using Item = typename T::value_type;
+
+            uint64_t length{};
+            read(length);
+
+            if (length > (size_ - pos_) / sizeof(Item))
+                failed_ = true;
+
+            if (const char* bytes = read_bytes(length * sizeof(Item)))
+            {
+                value.resize(length);
+                if (length > 0)
+                    std::memcpy(value.data(), bytes, length * sizeof(Item));
+            }
+        }
+        else
+        {
+            static_assert(std::is_trivially_copyable_v<T>, "Type is not supported by a binary archive");
+
+            if (const char* bytes = read_bytes(sizeof(T)))
+                std::memcpy(&value, bytes, sizeof(T));
+        }
+    }
+
+    const char* read_bytes(uint64_t count)
+    {
+        if (failed_ || count > size_ - pos_)
+        {
+            failed_ = true;
+            return nullptr;
+        }
+
+        const char* bytes = data_ + pos_;
+        pos_ += count;
+        return bytes;
+    }
+};
+
+template <template <typename> class Serializer>
+struct IsBinarySerializer : std::false_type
+{ };
+
+template <>
+struct IsBinarySerializer<BinaryOutputSerializer> : std::true_type
+{ };
+
+template <>
+struct IsBinarySerializer<BinaryInputSerializer> : std::true_type
+{ };
+
+#endif
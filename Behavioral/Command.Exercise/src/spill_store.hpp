@@ -0,0 +1,144 @@
+#ifndef SPILL_STORE_HPP
+#define SPILL_STORE_HPP
+
+#include "serializers.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <string>
+
+// Local file for mementos evicted from memory.
+// Objects are written with a binary archive - they have to provide serialize(Archive&).
+// Ranges of released objects are reused by later writes, so the file does not outgrow
+// the largest set of objects spilled at the same time (plus fragmentation).
+class SpillStore
+{
+public:
+    struct Handle
+    {
+        uint64_t offset{};
+        uint64_t size{};
+    };
+
+    explicit SpillStore(std::string file_path)
+        : file_path_{std::move(file_path)}
+        , file_{file_path_, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc}
+    {
+        if (!file_)
+            throw std::runtime_error("Spill file not opened: " + file_path_);
+    }
+
+    SpillStore(const SpillStore&) = delete;
+    SpillStore& operator=(const SpillStore&) = delete;
+
+    ~SpillStore()
+    {
+        file_.close();
+        std::remove(file_path_.c_str());
+    }
+
+    template <typename T>
+    Handle write(T& value)
+    {
+        buffer_.clear();
+        BinaryOutputSerializer<std::string> archive{buffer_};
+        value.serialize(archive);
+
+        const Handle handle{allocate(buffer_.size()), buffer_.size()};
+        file_.seekp(static_cast<std::streamoff>(handle.offset));
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        if (!file_)
+        {
+            release(handle);
+            throw std::runtime_error("Writing to spill file failed: " + file_path_);
+        }
+
+        return handle;
+    }
+
+    template <typename T>
+    void read(const Handle& handle, T& value)
+    {
+        buffer_.resize(handle.size);
+        file_.seekg(static_cast<std::streamoff>(handle.offset));
+        file_.read(buffer_.data(), static_cast<std::streamsize>(handle.size));
+
+        BinaryInputSerializer<std::string> archive{buffer_};
+        if (!file_ || !value.serialize(archive))
+            throw std::runtime_error("Reading from spill file failed: " + file_path_);
+    }
+
+    // the range of an object may be overwritten by the next write
+    void release(const Handle& handle)
+    {
+        if (handle.size == 0)
+            return;
+
+        auto next = free_.lower_bound(handle.offset);
+        uint64_t offset = handle.offset;
+        uint64_t size = handle.size;
+
+        // adjacent free ranges are merged
+        if (next != free_.begin())
+        {
+            auto prev = std::prev(next);
+            if (prev->first + prev->second == offset)
+            {
+                offset = prev->first;
+                size += prev->second;
+                free_.erase(prev);
+            }
+        }
+
+        if (next != free_.end() && offset + size == next->first)
+        {
+            size += next->second;
+            free_.erase(next);
+        }
+
+        free_.emplace(offset, size);
+    }
+
+    uint64_t file_size() const
+    {
+        return end_;
+    }
+
+private:
+    std::string file_path_;
+    std::fstream file_;
+    std::string buffer_;
+    uint64_t end_{};
+    std::map<uint64_t, uint64_t> free_; // offset -> size of released ranges
+
+    // first fit - a free range at the end of the file is extended if needed
+    uint64_t allocate(uint64_t size)
+    {
+        for (auto it = free_.begin(); it != free_.end(); ++it)
+        {
+            const auto [offset, free_size] = *it;
+            const bool at_end = offset + free_size == end_;
+            if (free_size < size && !at_end)
+                continue;
+
+            free_.erase(it);
+            if (free_size > size)
+                free_.emplace(offset + size, free_size - size);
+            else
+                end_ = std::max(end_, offset + size);
+
+            return offset;
+        }
+
+        const uint64_t offset = end_;
+        end_ += size;
+
+        return offset;
+    }
+};
+
+#endif // SPILL_STORE_HPP
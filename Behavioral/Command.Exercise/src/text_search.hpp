@@ -0,0 +1,40 @@
+#ifndef TEXT_SEARCH_HPP
+#define TEXT_SEARCH_HPP
+
+#include <cstring>
+#include <string_view>
+
+namespace TextSearch
+{
+    constexpr size_t npos = std::string_view::npos;
+
+    // Finds the first occurrence of pattern in text at or after from.
+    // Candidates are located with memchr (vectorized by the C library) on the first byte
+    // and rejected cheaply on the last byte before the whole pattern is compared.
+    inline size_t find(std::string_view text, std::string_view pattern, size_t from = 0)
+    {
+        const size_t m = pattern.size();
+
+        if (m == 0 || from > text.size() || text.size() - from < m)
+            return npos;
+
+        const char first = pattern.front();
+        const char last = pattern.back();
+        const char* const begin = text.data();
+        const char* const end = begin + text.size() - m + 1; // one past the last possible start
+
+        for (const char* pos = begin + from; pos < end; ++pos)
+        {
+            pos = static_cast<const char*>(std::memchr(pos, first, end - pos));
+            if (pos == nullptr)
+                return npos;
+
+            if (pos[m - 1] == last && std::memcmp(pos + 1, pattern.data() + 1, m - 1) == 0)
+                return static_cast<size_t>(pos - begin);
+        }
+
+        return npos;
+    }
+}
+
+#endif // TEXT_SEARCH_HPP
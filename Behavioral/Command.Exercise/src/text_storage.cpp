@@ -0,0 +1,343 @@
+#include "text_storage.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+PieceTableStorage::PieceTableStorage(std::string text)
+    : original_{std::move(text)}
+{
+    if (!original_.empty())
+        root_ = make_node(Piece{Buffer::original, 0, original_.size()});
+}
+
+PieceTableStorage::PieceTableStorage(const PieceTableStorage& other)
+    : original_{other.original_}
+    , added_{other.added_}
+    , added_live_{other.added_live_}
+    , root_{copy_tree(other.root_)}
+    , seed_{other.seed_}
+{
+}
+
+PieceTableStorage& PieceTableStorage::operator=(const PieceTableStorage& other)
+{
+    if (this != &other)
+    {
+        PieceTableStorage temp{other};
+        *this = std::move(temp);
+    }
+
+    return *this;
+}
+
+size_t PieceTableStorage::length() const
+{
+    return length_of(root_);
+}
+
+void PieceTableStorage::insert(size_t pos, std::string_view text)
+{
+    assert(pos <= length());
+
+    if (text.empty())
+        return;
+
+    const size_t erased_bytes = added_.size() - added_live_;
+    if (erased_bytes >= compaction_min_bytes && erased_bytes >= added_live_)
+        compact_added();
+
+    const size_t added_end = added_.size();
+    added_.append(text.data(), text.size());
+    added_live_ += text.size();
+
+    // typing at the end of a document just extends the last piece
+    if (root_ && pos == root_->subtree_length && extend_last(*root_, added_end, text.size()))
+        return;
+
+    auto [left, right] = split(std::move(root_), pos);
+    auto node = make_node(Piece{Buffer::added, added_end, text.size()});
+    root_ = merge(merge(std::move(left), std::move(node)), std::move(right));
+}
+
+void PieceTableStorage::erase(size_t pos, size_t count)
+{
+    const size_t len = length();
+
+    if (pos >= len || count == 0)
+        return;
+
+    count = std::min(count, len - pos);
+
+    auto [left, rest] = split(std::move(root_), pos);
+    auto [erased, right] = split(std::move(rest), count);
+    root_ = merge(std::move(left), std::move(right));
+
+    added_live_ -= added_length_of(erased);
+    recycle(std::move(erased));
+}
+
+void PieceTableStorage::clear()
+{
+    recycle(std::move(root_));
+    original_.clear();
+    added_.clear();
+    added_live_ = 0;
+}
+
+void PieceTableStorage::for_each_chunk(const ChunkReader& reader) const
+{
+    for_each_chunk(0, length(), reader);
+}
+
+void PieceTableStorage::for_each_chunk(size_t pos, size_t count, const ChunkReader& reader) const
+{
+    visit_range(root_, pos, count, [this, &reader](const Piece& piece, size_t offset, size_t size) {
+        reader(std::string_view{data_of(piece) + offset, size});
+    });
+}
+
+void PieceTableStorage::transform_chunks(const ChunkWriter& writer)
+{
+    transform_chunks(0, length(), writer);
+}
+
+void PieceTableStorage::transform_chunks(size_t pos, size_t count, const ChunkWriter& writer)
+{
+    visit_range(root_, pos, count, [this, &writer](const Piece& piece, size_t offset, size_t size) {
+        writer(data_of(piece) + offset, size);
+    });
+}
+
+size_t PieceTableStorage::piece_count() const
+{
+    return count_of(root_);
+}
+
+size_t PieceTableStorage::added_bytes() const
+{
+    return added_.size();
+}
+
+PieceTableStorage::NodePtr PieceTableStorage::make_node(const Piece& piece)
+{
+    if (!free_nodes_)
+        return std::make_unique<Node>(piece, next_priority());
+
+    NodePtr node = std::move(free_nodes_);
+    free_nodes_ = std::move(node->right);
+    --free_count_;
+
+    node->piece = piece;
+    node->priority = next_priority();
+    node->subtree_length = piece.length;
+
+    return node;
+}
+
+void PieceTableStorage::recycle(NodePtr node)
+{
+    if (!node)
+        return;
+
+    recycle(std::move(node->left));
+    recycle(std::move(node->right));
+
+    if (free_count_ < max_free_nodes)
+    {
+        node->right = std::move(free_nodes_);
+        free_nodes_ = std::move(node);
+        ++free_count_;
+    }
+}
+
+uint32_t PieceTableStorage::next_priority()
+{
+    // xorshift32 - deterministic and cheap
+    seed_ ^= seed_ << 13;
+    seed_ ^= seed_ >> 17;
+    seed_ ^= seed_ << 5;
+
+    return seed_;
+}
+
+const char* PieceTableStorage::data_of(const Piece& piece) const
+{
+    const std::string& buffer = (piece.buffer == Buffer::original) ? original_ : added_;
+
+    return buffer.data() + piece.offset;
+}
+
+char* PieceTableStorage::data_of(const Piece& piece)
+{
+    std::string& buffer = (piece.buffer == Buffer::original) ? original_ : added_;
+
+    return buffer.data() + piece.offset;
+}
+
+size_t PieceTableStorage::length_of(const NodePtr& node)
+{
+    return node ? node->subtree_length : 0;
+}
+
+size_t PieceTableStorage::count_of(const NodePtr& node)
+{
+    return node ? 1 + count_of(node->left) + count_of(node->right) : 0;
+}
+
+void PieceTableStorage::update(Node& node)
+{
+    node.subtree_length = length_of(node.left) + node.piece.length + length_of(node.right);
+}
+
+PieceTableStorage::NodePtr PieceTableStorage::merge(NodePtr left, NodePtr right)
+{
+    if (!left)
+        return right;
+    if (!right)
+        return left;
+
+    if (left->priority > right->priority)
+    {
+        left->right = merge(std::move(left->right), std::move(right));
+        update(*left);
+        return left;
+    }
+
+    right->left = merge(std::move(left), std::move(right->left));
+    update(*right);
+    return right;
+}
+
+std::pair<PieceTableStorage::NodePtr, PieceTableStorage::NodePtr> PieceTableStorage::split(NodePtr node, size_t pos)
+{
+    if (!node)
+        return {nullptr, nullptr};
+
+    const size_t left_length = length_of(node->left);
+    const size_t piece_end = left_length + node->piece.length;
+
+    if (pos <= left_length)
+    {
+        auto [left, right] = split(std::move(node->left), pos);
+        node->left = std::move(right);
+        update(*node);
+        return {std::move(left), std::move(node)};
+    }
+
+    if (pos >= piece_end)
+    {
+        auto [left, right] = split(std::move(node->right), pos - piece_end);
+        node->right = std::move(left);
+        update(*node);
+        return {std::move(node), std::move(right)};
+    }
+
+    // split point falls inside a piece - the tail becomes a new node
+    const size_t head_length = pos - left_length;
+    auto tail = make_node(Piece{node->piece.buffer, node->piece.offset + head_length, node->piece.length - head_length});
+    node->piece.length = head_length;
+
+    NodePtr right = merge(std::move(tail), std::move(node->right));
+    update(*node);
+
+    return {std::move(node), std::move(right)};
+}
+
+bool PieceTableStorage::extend_last(Node& node, size_t added_end, size_t count)
+{
+    if (node.right)
+    {
+        if (!extend_last(*node.right, added_end, count))
+            return false;
+    }
+    else
+    {
+        if (node.piece.buffer != Buffer::added || node.piece.offset + node.piece.length != added_end)
+            return false;
+
+        node.piece.length += count;
+    }
+
+    node.subtree_length += count;
+    return true;
+}
+
+PieceTableStorage::NodePtr PieceTableStorage::copy_tree(const NodePtr& node)
+{
+    if (!node)
+        return nullptr;
+
+    auto copy = std::make_unique<Node>(node->piece, node->priority);
+    copy->subtree_length = node->subtree_length;
+    copy->left = copy_tree(node->left);
+    copy->right = copy_tree(node->right);
+
+    return copy;
+}
+
+size_t PieceTableStorage::added_length_of(const NodePtr& node)
+{
+    if (!node)
+        return 0;
+
+    const size_t own_length = (node->piece.buffer == Buffer::added) ? node->piece.length : 0;
+
+    return own_length + added_length_of(node->left) + added_length_of(node->right);
+}
+
+// live pieces are copied in text order - the last piece of a text stays at the end of added_,
+// so typing at the end still extends it
+void PieceTableStorage::compact_added()
+{
+    spare_.clear();
+    spare_.reserve(added_.capacity());
+
+    if (root_)
+        move_added(*root_);
+
+    added_.swap(spare_);
+    spare_.clear();
+}
+
+void PieceTableStorage::move_added(Node& node)
+{
+    if (node.left)
+        move_added(*node.left);
+
+    if (node.piece.buffer == Buffer::added)
+    {
+        const size_t offset = spare_.size();
+        spare_.append(added_, node.piece.offset, node.piece.length);
+        node.piece.offset = offset;
+    }
+
+    if (node.right)
+        move_added(*node.right);
+}
+
+// calls action(piece, offset_in_piece, size) for every part of a piece overlapping [pos, pos + count)
+template <typename Action>
+void PieceTableStorage::visit_range(const NodePtr& node, size_t pos, size_t count, Action action)
+{
+    if (!node || count == 0)
+        return;
+
+    const size_t left_length = length_of(node->left);
+    const size_t piece_end = left_length + node->piece.length;
+    const size_t end = pos + count;
+
+    if (pos < left_length)
+        visit_range(node->left, pos, std::min(end, left_length) - pos, action);
+
+    const size_t from = std::max(pos, left_length);
+    const size_t to = std::min(end, piece_end);
+    if (from < to)
+        action(node->piece, from - left_length, to - from);
+
+    if (end > piece_end)
+    {
+        const size_t right_pos = std::max(pos, piece_end);
+        visit_range(node->right, right_pos - piece_end, end - right_pos, action);
+    }
+}
@@ -0,0 +1,213 @@
+#ifndef TEXT_STORAGE_HPP
+#define TEXT_STORAGE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+class TextStorage
+{
+public:
+    using ChunkReader = std::function<void(std::string_view)>;
+    using ChunkWriter = std::function<void(char*, size_t)>;
+
+    virtual size_t length() const = 0;
+    virtual void insert(size_t pos, std::string_view text) = 0;
+    virtual void erase(size_t pos, size_t count) = 0;
+    virtual void clear() = 0;
+
+    // visits stored text in order as contiguous chunks - no copy of the whole text is made
+    virtual void for_each_chunk(const ChunkReader& reader) const = 0;
+    virtual void for_each_chunk(size_t pos, size_t count, const ChunkReader& reader) const = 0;
+    // gives in-place write access to stored chars (length of text can't be changed)
+    virtual void transform_chunks(const ChunkWriter& writer) = 0;
+    virtual void transform_chunks(size_t pos, size_t count, const ChunkWriter& writer) = 0;
+
+    virtual std::unique_ptr<TextStorage> clone() const = 0;
+    virtual ~TextStorage() = default;
+};
+
+using TextStoragePtr = std::unique_ptr<TextStorage>;
+
+template <typename Storage>
+class CloneableStorage : public TextStorage
+{
+public:
+    TextStoragePtr clone() const override
+    {
+        return std::make_unique<Storage>(static_cast<Storage const&>(*this));
+    }
+};
+
+//--------------------------------------------------------------------------------
+// Contiguous storage - O(n) edits in the middle of a text
+class StringStorage : public CloneableStorage<StringStorage>
+{
+    std::string text_;
+
+public:
+    StringStorage() = default;
+
+    explicit StringStorage(std::string text)
+        : text_{std::move(text)}
+    {
+    }
+
+    size_t length() const override
+    {
+        return text_.size();
+    }
+
+    void insert(size_t pos, std::string_view text) override
+    {
+        text_.insert(pos, text);
+    }
+
+    void erase(size_t pos, size_t count) override
+    {
+        text_.erase(pos, count);
+    }
+
+    void clear() override
+    {
+        text_.clear();
+    }
+
+    void for_each_chunk(const ChunkReader& reader) const override
+    {
+        for_each_chunk(0, text_.size(), reader);
+    }
+
+    void for_each_chunk(size_t pos, size_t count, const ChunkReader& reader) const override
+    {
+        count = clamp_count(pos, count);
+
+        if (count > 0)
+            reader(std::string_view{text_.data() + pos, count});
+    }
+
+    void transform_chunks(const ChunkWriter& writer) override
+    {
+        transform_chunks(0, text_.size(), writer);
+    }
+
+    void transform_chunks(size_t pos, size_t count, const ChunkWriter& writer) override
+    {
+        count = clamp_count(pos, count);
+
+        if (count > 0)
+            writer(text_.data() + pos, count);
+    }
+
+private:
+    size_t clamp_count(size_t pos, size_t count) const
+    {
+        return pos < text_.size() ? std::min(count, text_.size() - pos) : 0;
+    }
+};
+
+//--------------------------------------------------------------------------------
+// Piece table - pieces are kept in an implicit treap ordered by position in text,
+// so insert & erase cost O(log n) expected regardless of the size of a document.
+// Erased text stays in the add buffer until it outweighs the live added text - then
+// live pieces are copied to a spare buffer which takes the place of the add buffer.
+// Nodes of erased pieces are kept for reuse, so steady editing does not touch the heap.
+class PieceTableStorage : public CloneableStorage<PieceTableStorage>
+{
+    enum class Buffer : uint8_t
+    {
+        original,
+        added
+    };
+
+    struct Piece
+    {
+        Buffer buffer;
+        size_t offset;
+        size_t length;
+    };
+
+    struct Node;
+    using NodePtr = std::unique_ptr<Node>;
+
+    struct Node
+    {
+        Piece piece;
+        uint32_t priority;
+        size_t subtree_length;
+        NodePtr left;
+        NodePtr right;
+
+        Node(const Piece& p, uint32_t prio)
+            : piece{p}
+            , priority{prio}
+            , subtree_length{p.length}
+        {
+        }
+    };
+
+    std::string original_;
+    std::string added_;
+    std::string spare_; // keeps its capacity between compactions of added_
+    size_t added_live_{}; // bytes of added_ referenced by pieces
+    NodePtr root_;
+    NodePtr free_nodes_; // linked by right
+    size_t free_count_{};
+    uint32_t seed_{0x9E3779B9u};
+
+public:
+    // the add buffer is not compacted while it holds less erased text
+    static constexpr size_t compaction_min_bytes = 64 * 1024;
+    // nodes of erased pieces kept for reuse - the rest is released
+    static constexpr size_t max_free_nodes = 256;
+
+    PieceTableStorage() = default;
+    explicit PieceTableStorage(std::string text);
+
+    PieceTableStorage(const PieceTableStorage& other);
+    PieceTableStorage& operator=(const PieceTableStorage& other);
+    PieceTableStorage(PieceTableStorage&&) noexcept = default;
+    PieceTableStorage& operator=(PieceTableStorage&&) noexcept = default;
+    ~PieceTableStorage() override = default;
+
+    size_t length() const override;
+    void insert(size_t pos, std::string_view text) override;
+    void erase(size_t pos, size_t count) override;
+    void clear() override;
+    void for_each_chunk(const ChunkReader& reader) const override;
+    void for_each_chunk(size_t pos, size_t count, const ChunkReader& reader) const override;
+    void transform_chunks(const ChunkWriter& writer) override;
+    void transform_chunks(size_t pos, size_t count, const ChunkWriter& writer) override;
+
+    size_t piece_count() const;
+
+    // bytes held by the add buffer - including erased text not yet reclaimed
+    size_t added_bytes() const;
+
+private:
+    NodePtr make_node(const Piece& piece);
+    void recycle(NodePtr node);
+    uint32_t next_priority();
+    const char* data_of(const Piece& piece) const;
+    char* data_of(const Piece& piece);
+
+    static size_t length_of(const NodePtr& node);
+    static size_t count_of(const NodePtr& node);
+    static void update(Node& node);
+    static NodePtr merge(NodePtr left, NodePtr right);
+    std::pair<NodePtr, NodePtr> split(NodePtr node, size_t pos);
+    static bool extend_last(Node& node, size_t added_end, size_t count);
+    static NodePtr copy_tree(const NodePtr& node);
+    static size_t added_length_of(const NodePtr& node);
+    void compact_added();
+    void move_added(Node& node);
+
+    template <typename Action>
+    static void visit_range(const NodePtr& node, size_t pos, size_t count, Action action);
+};
+
+#endif // TEXT_STORAGE_HPP
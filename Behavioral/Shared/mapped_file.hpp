@@ -0,0 +1,88 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file (on Windows the file is read to memory).
+// Pages are read ahead - files are expected to be read from the beginning to the end.
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& file_path);
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile();
+
+    std::string_view data() const
+    {
+        return std::string_view{data_, size_};
+    }
+
+private:
+    const char* data_{};
+    size_t size_{};
+#ifdef _WIN32
+    std::string content_;
+#endif
+};
+
+#ifdef _WIN32
+inline MappedFile::MappedFile(const std::string& file_path)
+{
+    std::ifstream file{file_path, std::ios::binary};
+    if (!file)
+        throw std::runtime_error("File not opened: " + file_path);
+
+    content_.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    data_ = content_.data();
+    size_ = content_.size();
+}
+
+inline MappedFile::~MappedFile() = default;
+#else
+inline MappedFile::MappedFile(const std::string& file_path)
+{
+    const int fd = ::open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::runtime_error("File not opened: " + file_path);
+
+    struct stat info{};
+    if (::fstat(fd, &info) == 0 && info.st_size > 0)
+    {
+        void* data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+        {
+            ::madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(data);
+            size_ = static_cast<size_t>(info.st_size);
+        }
+    }
+    ::close(fd);
+
+    if (!data_ && info.st_size > 0)
+        throw std::runtime_error("File not mapped: " + file_path);
+}
+
+inline MappedFile::~MappedFile()
+{
+    if (data_)
+        ::munmap(const_cast<char*>(data_), size_);
+}
+#endif
+
+#endif // MAPPED_FILE_HPP
@@ -0,0 +1,218 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Thread pool with task queues per worker. A worker takes tasks it submitted itself from the back
+// of its own queue (the most recently submitted - still hot in cache) and steals from the front of
+// other queues when its own is empty. Tasks submitted from outside the pool are spread round-robin
+// and taken in submission order, so none of them starves behind newer ones.
+class WorkStealingPool
+{
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(size_t thread_count = std::thread::hardware_concurrency())
+    {
+        if (thread_count == 0)
+            thread_count = 1;
+
+        for (size_t i = 0; i < thread_count; ++i)
+            queues_.push_back(std::make_unique<WorkQueue>());
+
+        for (size_t i = 0; i < thread_count; ++i)
+            threads_.emplace_back([this, i] { run_worker(i); });
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // all submitted tasks are finished before workers are joined
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lk{idle_mtx_};
+            done_ = true;
+        }
+        idle_cv_.notify_all();
+
+        for (auto& thread : threads_)
+            thread.join();
+    }
+
+    void submit(Task task)
+    {
+        push(std::move(task), /* at_back */ true);
+    }
+
+    // called from a task - the task is queued behind other tasks of the current worker
+    // (used by long-running work split into parts to give other tasks a turn)
+    void defer(Task task)
+    {
+        push(std::move(task), /* at_back */ current_pool_ != this);
+    }
+
+    // runs one queued task on the calling thread and returns false if there is none - a thread
+    // waiting for results of its forked tasks helps instead of blocking a worker (fork-join)
+    bool run_pending_task()
+    {
+        Task task;
+        const bool is_worker = (current_pool_ == this);
+
+        if ((is_worker && try_pop(current_index_, task)) || steal(is_worker ? current_index_ : 0, task))
+        {
+            task();
+            return true;
+        }
+
+        return false;
+    }
+
+    size_t thread_count() const
+    {
+        return threads_.size();
+    }
+
+private:
+    struct WorkQueue
+    {
+        std::mutex mtx;
+        std::deque<Task> tasks; // submitted by the worker
+        std::deque<Task> submitted; // submitted from outside the pool - FIFO
+    };
+
+    std::vector<std::unique_ptr<WorkQueue>> queues_;
+    std::vector<std::thread> threads_;
+    std::atomic<size_t> next_queue_{0};
+
+    std::mutex idle_mtx_;
+    std::condition_variable idle_cv_;
+    std::atomic<size_t> pending_{0}; // tasks in the queues - changed under the lock of a queue
+    bool done_{};
+
+    // how long an idle worker sleeps without tasks - a push wakes it earlier
+    static constexpr std::chrono::seconds idle_wait{1};
+
+    inline static thread_local const WorkStealingPool* current_pool_ = nullptr;
+    inline static thread_local size_t current_index_ = 0;
+
+    void push(Task task, bool at_back)
+    {
+        const bool from_worker = (current_pool_ == this);
+        const size_t index = from_worker ? current_index_ : next_queue_++ % queues_.size();
+
+        {
+            std::lock_guard<std::mutex> lk{queues_[index]->mtx};
+            if (!from_worker)
+                queues_[index]->submitted.push_back(std::move(task));
+            else if (at_back)
+                queues_[index]->tasks.push_back(std::move(task));
+            else
+                queues_[index]->tasks.push_front(std::move(task));
+
+            ++pending_;
+        }
+
+        // a worker checking pending_ under the lock cannot miss the notification
+        {
+            std::lock_guard<std::mutex> lk{idle_mtx_};
+        }
+        idle_cv_.notify_one();
+    }
+
+    void run_worker(size_t index)
+    {
+        current_pool_ = this;
+        current_index_ = index;
+
+        while (true)
+        {
+            Task task;
+            if (try_pop(index, task) || steal(index, task))
+            {
+                task();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lk{idle_mtx_};
+            if (done_ && pending_ == 0)
+                return;
+
+            idle_cv_.wait_for(lk, idle_wait, [this] { return pending_ > 0 || done_; });
+        }
+    }
+
+    bool try_pop(size_t index, Task& task)
+    {
+        WorkQueue& queue = *queues_[index];
+        std::lock_guard<std::mutex> lk{queue.mtx};
+
+        if (!queue.tasks.empty())
+        {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+            --pending_;
+            return true;
+        }
+
+        return take_front(queue.submitted, task);
+    }
+
+    bool take_front(std::deque<Task>& tasks, Task& task)
+    {
+        if (tasks.empty())
+            return false;
+
+        task = std::move(tasks.front());
+        tasks.pop_front();
+        --pending_;
+        return true;
+    }
+
+    // queues locked by other threads are skipped at first - then, while any task is queued,
+    // they are searched with blocking locks, so a thread never goes idle with work left
+    bool steal(size_t thief_index, Task& task)
+    {
+        if (try_steal(thief_index, task))
+            return true;
+
+        while (pending_ > 0)
+        {
+            for (size_t i = 1; i <= queues_.size(); ++i)
+            {
+                WorkQueue& queue = *queues_[(thief_index + i) % queues_.size()];
+                std::lock_guard<std::mutex> lk{queue.mtx};
+
+                if (take_front(queue.tasks, task) || take_front(queue.submitted, task))
+                    return true;
+            }
+        }
+
+        return false;
+    }
+
+    // the queue of the thief is checked last - a thread outside the pool checks all queues
+    bool try_steal(size_t thief_index, Task& task)
+    {
+        for (size_t i = 1; i <= queues_.size(); ++i)
+        {
+            WorkQueue& queue = *queues_[(thief_index + i) % queues_.size()];
+            std::unique_lock<std::mutex> lk{queue.mtx, std::try_to_lock};
+
+            if (lk.owns_lock() && (take_front(queue.tasks, task) || take_front(queue.submitted, task)))
+                return true;
+        }
+
+        return false;
+    }
+};
+
+#endif // THREAD_POOL_HPP
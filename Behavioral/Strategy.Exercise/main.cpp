@@ -2,7 +2,9 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <list>
+#include <memory>
 #include <numeric>
 #include <stdexcept>
 #include <string>
@@ -30,52 +32,181 @@ using Results = std::vector<StatResult>;
 //     sum
 // };
 
+// Per-element part of a statistic - fed with consecutive blocks of data, it lets
+// CompositeAlgorithm compute many statistics in one pass
+class Accumulator
+{
+public:
+    virtual void add(const double* first, const double* last) = 0;
+    virtual Results results() const = 0;
+    virtual ~Accumulator() = default;
+};
+
 class Statistics
 {
 public:
     virtual Results calculate(Data& data) = 0;
+
+    // nullptr - statistics can't be computed element by element
+    virtual std::unique_ptr<Accumulator> make_accumulator() const
+    {
+        return nullptr;
+    }
+
     virtual ~Statistics() = default;
+
+protected:
+    static Results accumulate(Accumulator& accumulator, const Data& data)
+    {
+        accumulator.add(data.data(), data.data() + data.size());
+        return accumulator.results();
+    }
 };
 
 class Avg : public Statistics
 {
+    class AvgAccumulator : public Accumulator
+    {
+        double sum_{};
+        size_t count_{};
+
+    public:
+        void add(const double* first, const double* last) override
+        {
+            sum_ = std::accumulate(first, last, sum_);
+            count_ += last - first;
+        }
+
+        Results results() const override
+        {
+            return Results{StatResult{"Avg", sum_ / count_}};
+        }
+    };
+
     Results calculate(Data& data) override
-    {    
-        double sum = std::accumulate(data.begin(), data.end(), 0.0);
-        double avg = sum / data.size();
-     
-        return Results{StatResult{"Avg", avg}}; // r-value
+    {
+        AvgAccumulator accumulator;
+        return accumulate(accumulator, data);
+    }
+
+    std::unique_ptr<Accumulator> make_accumulator() const override
+    {
+        return std::make_unique<AvgAccumulator>();
     }
 };
 
 class MinMax : public Statistics
 {
+    class MinMaxAccumulator : public Accumulator
+    {
+        double min_{std::numeric_limits<double>::infinity()};
+        double max_{-std::numeric_limits<double>::infinity()};
+
+    public:
+        // both in one loop - std::min_element and std::max_element would read data twice
+        void add(const double* first, const double* last) override
+        {
+            for (; first != last; ++first)
+            {
+                min_ = std::min(min_, *first);
+                max_ = std::max(max_, *first);
+            }
+        }
+
+        // no data - Min & Max are NaN, like Avg (min_element & max_element would return end of data)
+        Results results() const override
+        {
+            const bool empty = min_ > max_;
+            const double nan = std::numeric_limits<double>::quiet_NaN();
+
+            Results results;
+            results.push_back(StatResult("Min", empty ? nan : min_));
+            results.push_back(StatResult("Max", empty ? nan : max_));
+            return results;
+        }
+    };
+
     Results calculate(Data& data) override
     {
-        Results results;
-        double min = *(std::min_element(data.begin(), data.end()));
-        double max = *(std::max_element(data.begin(), data.end()));
+        MinMaxAccumulator accumulator;
+        return accumulate(accumulator, data);
+    }
 
-        results.push_back(StatResult("Min", min));
-        results.push_back(StatResult("Max", max));
-        return results;
+    std::unique_ptr<Accumulator> make_accumulator() const override
+    {
+        return std::make_unique<MinMaxAccumulator>();
     }
 };
 
 class Sum : public Statistics
 {
+    class SumAccumulator : public Accumulator
+    {
+        double sum_{};
+
+    public:
+        void add(const double* first, const double* last) override
+        {
+            sum_ = std::accumulate(first, last, sum_);
+        }
+
+        Results results() const override
+        {
+            Results results;
+            results.push_back(StatResult("Sum", sum_));
+            return results;
+        }
+    };
+
     Results calculate(Data& data) override
     {
-        Results results;
-        double sum = std::accumulate(data.begin(), data.end(), 0.0);
+        SumAccumulator accumulator;
+        return accumulate(accumulator, data);
+    }
 
-        results.push_back(StatResult("Sum", sum));
-        return results;
+    std::unique_ptr<Accumulator> make_accumulator() const override
+    {
+        return std::make_unique<SumAccumulator>();
     }
 };
 
+// Statistics with accumulators are computed in one pass over data - it is read in blocks small
+// enough to stay in L1 cache while every accumulator processes them. Other statistics read data
+// on their own. Results keep the order of added statistics.
+// A composite nested in another one joins its pass when all its statistics have accumulators.
 class CompositeAlgorithm : public Statistics
 {
+    static constexpr size_t block_size = 2048; // 16 KB of doubles
+
+    class CompositeAccumulator : public Accumulator
+    {
+        std::vector<std::unique_ptr<Accumulator>> accumulators_;
+
+    public:
+        explicit CompositeAccumulator(std::vector<std::unique_ptr<Accumulator>> accumulators)
+            : accumulators_{std::move(accumulators)}
+        {
+        }
+
+        void add(const double* first, const double* last) override
+        {
+            for (const auto& accumulator : accumulators_)
+                accumulator->add(first, last);
+        }
+
+        Results results() const override
+        {
+            Results results;
+            for (const auto& accumulator : accumulators_)
+            {
+                Results tmp_result = accumulator->results();
+                results.insert(results.end(), tmp_result.begin(), tmp_result.end());
+            }
+
+            return results;
+        }
+    };
+
     std::vector<std::shared_ptr<Statistics>> stats_;
 public:
     void add_statistics(std::shared_ptr<Statistics> stat)
@@ -85,16 +216,50 @@ public:
 
     Results calculate(Data& data) override
     {
+        std::vector<std::unique_ptr<Accumulator>> accumulators;
+        accumulators.reserve(stats_.size());
+        for (const auto& stat : stats_)
+            accumulators.push_back(stat->make_accumulator());
+
+        for (size_t offset = 0; offset < data.size(); offset += block_size)
+        {
+            const double* first = data.data() + offset;
+            const double* last = first + std::min(block_size, data.size() - offset);
+
+            for (const auto& accumulator : accumulators)
+            {
+                if (accumulator)
+                    accumulator->add(first, last);
+            }
+        }
+
         Results results{};
 
-        for(const auto& stat : stats_)
+        for (size_t i = 0; i < stats_.size(); ++i)
         {
-            Results tmp_result = stat->calculate(data);
+            Results tmp_result = accumulators[i] ? accumulators[i]->results() : stats_[i]->calculate(data);
             results.insert(results.end(), tmp_result.begin(), tmp_result.end());
         }
 
         return results;
     }
+
+    std::unique_ptr<Accumulator> make_accumulator() const override
+    {
+        std::vector<std::unique_ptr<Accumulator>> accumulators;
+        accumulators.reserve(stats_.size());
+
+        for (const auto& stat : stats_)
+        {
+            auto accumulator = stat->make_accumulator();
+            if (!accumulator)
+                return nullptr;
+
+            accumulators.push_back(std::move(accumulator));
+        }
+
+        return std::make_unique<CompositeAccumulator>(std::move(accumulators));
+    }
 };
 
 class DataAnalyzer
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "batch_eval.hpp"
+#include "tree_generators.hpp"
+#include "visitors.hpp"
+
+namespace
+{
+    constexpr size_t variable_count = 4;
+    constexpr size_t row_count = 1 << 20;
+
+    // column per variable
+    std::vector<std::vector<int>> make_columns()
+    {
+        std::vector<std::vector<int>> columns(variable_count, std::vector<int>(row_count));
+        for (size_t v = 0; v < variable_count; ++v)
+        {
+            for (size_t row = 0; row < row_count; ++row)
+                columns[v][row] = static_cast<int>((row + v) % 10);
+        }
+
+        return columns;
+    }
+
+    // formulas of 2 * leaves - 1 nodes
+    void formula_sizes(benchmark::internal::Benchmark* bench)
+    {
+        bench->ArgName("leaves")->Arg(8)->Arg(64)->Unit(benchmark::kMillisecond);
+    }
+}
+
+// baseline - the tree is walked with virtual calls for every row
+static void BM_ExprEvalVisitor_PerRow(benchmark::State& state)
+{
+    auto expr = TreeGenerators::formula(state.range(0), variable_count);
+    const auto columns = make_columns();
+    std::vector<int> output(row_count);
+    std::vector<int> row(variable_count);
+
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            for (size_t v = 0; v < variable_count; ++v)
+                row[v] = columns[v][i];
+
+            ExprEvalVisitor visitor{&row};
+            expr->accept(visitor);
+            output[i] = visitor.result();
+        }
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * row_count);
+}
+BENCHMARK(BM_ExprEvalVisitor_PerRow)->Apply(formula_sizes);
+
+static void BM_BatchEvaluator(benchmark::State& state)
+{
+    auto expr = TreeGenerators::formula(state.range(0), variable_count);
+    const auto columns = make_columns();
+    std::vector<int> output(row_count);
+
+    std::vector<const int*> column_data;
+    for (const auto& column : columns)
+        column_data.push_back(column.data());
+
+    BatchEvaluator evaluator{*expr};
+    for (auto _ : state)
+    {
+        evaluator.evaluate(column_data, row_count, output.data());
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * row_count);
+}
+BENCHMARK(BM_BatchEvaluator)->Apply(formula_sizes);
@@ -0,0 +1,137 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "binary_ast.hpp"
+#include "parser.hpp"
+#include "tree_generators.hpp"
+
+namespace
+{
+    constexpr size_t corpus_text_size = 64 << 20;
+
+    // random formulas (64 MB as text) written to a temporary file once
+    struct Corpus
+    {
+        std::string file_path = (std::filesystem::temp_directory_path() / "visitor_ast_corpus.bin").string();
+        size_t text_size{};
+        size_t expression_count{};
+
+        Corpus()
+        {
+            std::minstd_rand rng{42};
+            AST::Parser parser;
+            AST::BinaryAstWriter writer;
+            std::string text;
+
+            while (text_size < corpus_text_size)
+            {
+                text.clear();
+                TreeGenerators::append_random_formula(text, rng, 6);
+                writer.write(*parser.parse(text));
+
+                text_size += text.size() + 1;
+                ++expression_count;
+            }
+
+            writer.save(file_path);
+        }
+
+        Corpus(const Corpus&) = delete;
+        Corpus& operator=(const Corpus&) = delete;
+
+        ~Corpus()
+        {
+            std::remove(file_path.c_str());
+        }
+    };
+
+    const Corpus& corpus()
+    {
+        static const Corpus corpus;
+        return corpus;
+    }
+
+    const std::vector<int> row = {1, 2, 3, 4, 5, 6, 7, 8};
+}
+
+// opening costs the mapping only - counters compare the file with the text of the same formulas
+static void BM_MappedAstFile_Open(benchmark::State& state)
+{
+    const auto& expressions = corpus();
+    size_t file_size = 0;
+
+    for (auto _ : state)
+    {
+        AST::MappedAstFile file{expressions.file_path};
+        file_size = file.expressions().data().size();
+        benchmark::DoNotOptimize(file_size);
+    }
+
+    state.counters["file_bytes"] = static_cast<double>(file_size);
+    state.counters["text_bytes"] = static_cast<double>(expressions.text_size);
+}
+BENCHMARK(BM_MappedAstFile_Open)->Unit(benchmark::kMicrosecond);
+
+// walks sizes of expressions - nothing is decoded
+static void BM_MappedAstFile_Scan(benchmark::State& state)
+{
+    const auto& expressions = corpus();
+    size_t file_size = 0;
+
+    for (auto _ : state)
+    {
+        AST::MappedAstFile file{expressions.file_path};
+        size_t count = 0;
+        file.expressions().for_each([&](const AST::SerializedExpression&) { ++count; });
+        benchmark::DoNotOptimize(count);
+        file_size = file.expressions().data().size();
+    }
+
+    state.SetBytesProcessed(state.iterations() * file_size);
+    state.counters["expressions"] = static_cast<double>(expressions.expression_count);
+}
+BENCHMARK(BM_MappedAstFile_Scan)->Unit(benchmark::kMillisecond);
+
+static void BM_MappedAstFile_EvaluateInPlace(benchmark::State& state)
+{
+    const auto& expressions = corpus();
+    size_t file_size = 0;
+    std::vector<int> stack;
+
+    for (auto _ : state)
+    {
+        AST::MappedAstFile file{expressions.file_path};
+        int sum = 0;
+        file.expressions().for_each([&](const AST::SerializedExpression& expr) { sum += expr.evaluate(stack, &row); });
+        benchmark::DoNotOptimize(sum);
+        file_size = file.expressions().data().size();
+    }
+
+    state.SetBytesProcessed(state.iterations() * file_size);
+}
+BENCHMARK(BM_MappedAstFile_EvaluateInPlace)->Unit(benchmark::kMillisecond);
+
+// every expression rebuilt as a tree (and destroyed) - compare with BM_Parser_Tree
+static void BM_MappedAstFile_BuildTrees(benchmark::State& state)
+{
+    const auto& expressions = corpus();
+    size_t file_size = 0;
+
+    for (auto _ : state)
+    {
+        AST::MappedAstFile file{expressions.file_path};
+        file.expressions().for_each([&](const AST::SerializedExpression& expr) {
+            auto tree = expr.build();
+            benchmark::DoNotOptimize(tree.get());
+        });
+        file_size = file.expressions().data().size();
+    }
+
+    state.SetBytesProcessed(state.iterations() * file_size);
+}
+BENCHMARK(BM_MappedAstFile_BuildTrees)->Unit(benchmark::kMillisecond);
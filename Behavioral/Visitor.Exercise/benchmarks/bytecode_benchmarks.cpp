@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "bytecode.hpp"
+#include "tree_generators.hpp"
+#include "visitors.hpp"
+
+namespace
+{
+    enum TreeShape
+    {
+        wide, // balanced
+        deep // left-leaning chain
+    };
+
+    AST::ExpressionNodePtr make_tree(TreeShape shape, size_t node_count)
+    {
+        return shape == wide ? TreeGenerators::balanced_tree((node_count + 1) / 2) : TreeGenerators::left_chain(node_count / 2);
+    }
+
+    void shapes_and_sizes(benchmark::internal::Benchmark* bench)
+    {
+        bench->ArgNames({"shape", "nodes"})->ArgsProduct({{wide, deep}, {1 << 10, 1 << 16}});
+    }
+}
+
+// repeated evaluation of the same expression
+static void BM_ExprEvalVisitor(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<TreeShape>(state.range(0)), state.range(1));
+
+    for (auto _ : state)
+    {
+        ExprEvalVisitor visitor;
+        expr->accept(visitor);
+        benchmark::DoNotOptimize(visitor.result());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_ExprEvalVisitor)->Apply(shapes_and_sizes);
+
+static void BM_BytecodeProgram_Run(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<TreeShape>(state.range(0)), state.range(1));
+    const auto program = BytecodeCompiler::compile(*expr);
+    std::vector<int> stack;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(program.run(stack));
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_BytecodeProgram_Run)->Apply(shapes_and_sizes);
+
+// one-time cost paid before the first run
+static void BM_BytecodeCompiler_Compile(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<TreeShape>(state.range(0)), state.range(1));
+
+    for (auto _ : state)
+    {
+        auto program = BytecodeCompiler::compile(*expr);
+        benchmark::DoNotOptimize(program.code().data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_BytecodeCompiler_Compile)->Apply(shapes_and_sizes);
@@ -0,0 +1,108 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "dag_optimizer.hpp"
+#include "flat_ast.hpp"
+#include "tree_generators.hpp"
+#include "visitors.hpp"
+
+namespace
+{
+    constexpr size_t variable_count = 4;
+
+    enum Workload
+    {
+        constants, // no variables - folds to one constant
+        repeated, // every other leaf is a variable - identical subtrees repeat
+        mixed // every 8th leaf is a variable - constant subtrees between them
+    };
+
+    AST::ExpressionNodePtr make_tree(Workload workload, size_t leaf_count)
+    {
+        switch (workload)
+        {
+        case constants:
+            return TreeGenerators::balanced_tree(leaf_count);
+        case repeated:
+            return TreeGenerators::formula(leaf_count, variable_count, 2);
+        case mixed:
+            return TreeGenerators::formula(leaf_count, variable_count, 8);
+        }
+
+        return nullptr;
+    }
+
+    const std::vector<int> row = {1, 2, 3, 4};
+
+    void workloads(benchmark::internal::Benchmark* bench)
+    {
+        bench->ArgNames({"workload", "leaves"})->ArgsProduct({{constants, repeated, mixed}, {1 << 10, 1 << 16}});
+    }
+}
+
+// one-time cost of the pass - counters show nodes of the tree and of the DAG
+static void BM_DagOptimizer_Optimize(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<Workload>(state.range(0)), state.range(1));
+    size_t tree_nodes = 0;
+    size_t dag_nodes = 0;
+
+    for (auto _ : state)
+    {
+        DagOptimizer optimizer;
+        expr->accept(optimizer);
+        tree_nodes = optimizer.tree_size();
+
+        auto dag = optimizer.release();
+        dag_nodes = dag.size();
+        benchmark::DoNotOptimize(dag_nodes);
+    }
+
+    state.counters["tree_nodes"] = static_cast<double>(tree_nodes);
+    state.counters["dag_nodes"] = static_cast<double>(dag_nodes);
+    state.counters["reduction"] = static_cast<double>(tree_nodes) / static_cast<double>(dag_nodes);
+    state.SetItemsProcessed(state.iterations() * tree_nodes);
+}
+BENCHMARK(BM_DagOptimizer_Optimize)->Apply(workloads);
+
+// baseline - every node of the tree is visited
+static void BM_DagOptimizer_EvalTree(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<Workload>(state.range(0)), state.range(1));
+
+    for (auto _ : state)
+    {
+        ExprEvalVisitor visitor{&row};
+        expr->accept(visitor);
+        benchmark::DoNotOptimize(visitor.result());
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DagOptimizer_EvalTree)->Apply(workloads);
+
+// the same tree in an arena - separates the gain of the flat layout from the gain of the optimization
+static void BM_DagOptimizer_EvalFlatTree(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<Workload>(state.range(0)), state.range(1));
+    const auto ast = AST::FlatAst::from(*expr);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ast.evaluate(&row));
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DagOptimizer_EvalFlatTree)->Apply(workloads);
+
+static void BM_DagOptimizer_EvalDag(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<Workload>(state.range(0)), state.range(1));
+    const auto dag = DagOptimizer::optimize(*expr);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(dag.evaluate(&row));
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DagOptimizer_EvalDag)->Apply(workloads);
@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include "ast.hpp"
+#include "flat_ast.hpp"
+#include "tree_generators.hpp"
+#include "visitors.hpp"
+
+namespace
+{
+    // 2 * leaves - 1 nodes
+    void tree_sizes(benchmark::internal::Benchmark* bench)
+    {
+        bench->ArgName("leaves")->Arg(1 << 10)->Arg(1 << 16)->Arg(5'000'000)->Unit(benchmark::kMillisecond);
+    }
+}
+
+static void BM_PointerAst_Build(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        auto expr = TreeGenerators::balanced_tree(state.range(0));
+        benchmark::DoNotOptimize(expr.get());
+
+        state.PauseTiming(); // destruction is measured separately
+        expr.reset();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (2 * state.range(0) - 1));
+}
+BENCHMARK(BM_PointerAst_Build)->Apply(tree_sizes);
+
+static void BM_FlatAst_Build(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        AST::FlatAst ast;
+        ast.reserve(2 * state.range(0) - 1);
+        TreeGenerators::balanced_tree(ast, state.range(0));
+        benchmark::DoNotOptimize(ast.size());
+
+        state.PauseTiming();
+        ast.clear();
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (2 * state.range(0) - 1));
+}
+BENCHMARK(BM_FlatAst_Build)->Apply(tree_sizes);
+
+static void BM_PointerAst_Destroy(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto expr = TreeGenerators::balanced_tree(state.range(0));
+        state.ResumeTiming();
+
+        expr.reset();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (2 * state.range(0) - 1));
+}
+BENCHMARK(BM_PointerAst_Destroy)->Apply(tree_sizes);
+
+static void BM_FlatAst_Destroy(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto ast = std::make_unique<AST::FlatAst>();
+        TreeGenerators::balanced_tree(*ast, state.range(0));
+        state.ResumeTiming();
+
+        ast.reset();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (2 * state.range(0) - 1));
+}
+BENCHMARK(BM_FlatAst_Destroy)->Apply(tree_sizes);
+
+static void BM_PointerAst_EvalVisitor(benchmark::State& state)
+{
+    auto expr = TreeGenerators::balanced_tree(state.range(0));
+
+    for (auto _ : state)
+    {
+        ExprEvalVisitor visitor;
+        expr->accept(visitor);
+        benchmark::DoNotOptimize(visitor.result());
+    }
+
+    state.SetItemsProcessed(state.iterations() * (2 * state.range(0) - 1));
+}
+BENCHMARK(BM_PointerAst_EvalVisitor)->Apply(tree_sizes);
+
+// the same visitor walking the arena through materialized nodes
+static void BM_FlatAst_EvalVisitor(benchmark::State& state)
+{
+    AST::FlatAst ast;
+    TreeGenerators::balanced_tree(ast, state.range(0));
+
+    for (auto _ : state)
+    {
+        ExprEvalVisitor visitor;
+        ast.accept(visitor);
+        benchmark::DoNotOptimize(visitor.result());
+    }
+
+    state.SetItemsProcessed(state.iterations() * (2 * state.range(0) - 1));
+}
+BENCHMARK(BM_FlatAst_EvalVisitor)->Apply(tree_sizes);
+
+static void BM_FlatAst_Evaluate(benchmark::State& state)
+{
+    AST::FlatAst ast;
+    TreeGenerators::balanced_tree(ast, state.range(0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ast.evaluate());
+
+    state.SetItemsProcessed(state.iterations() * (2 * state.range(0) - 1));
+}
+BENCHMARK(BM_FlatAst_Evaluate)->Apply(tree_sizes);
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include "tree_generators.hpp"
+#include "visitors.hpp"
+
+namespace
+{
+    enum TreeShape
+    {
+        wide, // balanced
+        deep // left-leaning chain
+    };
+
+    AST::ExpressionNodePtr make_tree(TreeShape shape, size_t node_count)
+    {
+        return shape == wide ? TreeGenerators::balanced_tree((node_count + 1) / 2) : TreeGenerators::left_chain(node_count / 2);
+    }
+
+    // deep trees stay shallow enough for the recursive visitor
+    void shapes_and_sizes(benchmark::internal::Benchmark* bench)
+    {
+        bench->ArgNames({"shape", "nodes"})->ArgsProduct({{wide, deep}, {1 << 10, 1 << 14}});
+    }
+}
+
+static void BM_RecursiveEval(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<TreeShape>(state.range(0)), state.range(1));
+
+    for (auto _ : state)
+    {
+        ExprEvalVisitor visitor;
+        expr->accept(visitor);
+        benchmark::DoNotOptimize(visitor.result());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_RecursiveEval)->Apply(shapes_and_sizes);
+
+static void BM_IterativeEval(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<TreeShape>(state.range(0)), state.range(1));
+    IterativeEvalVisitor visitor;
+
+    for (auto _ : state)
+    {
+        expr->accept(visitor);
+        benchmark::DoNotOptimize(visitor.result());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_IterativeEval)->Apply(shapes_and_sizes);
+
+// any depth - 10^7 nodes in a chain
+static void BM_IterativeEval_VeryDeep(benchmark::State& state)
+{
+    auto expr = TreeGenerators::left_chain(state.range(0) / 2);
+    IterativeEvalVisitor visitor;
+
+    for (auto _ : state)
+    {
+        expr->accept(visitor);
+        benchmark::DoNotOptimize(visitor.result());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_IterativeEval_VeryDeep)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
+
+static void BM_Teardown_VeryDeep(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        auto expr = TreeGenerators::left_chain(state.range(0) / 2);
+        state.ResumeTiming();
+
+        expr.reset();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Teardown_VeryDeep)->Arg(10'000'000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <thread>
+
+#include "parallel_eval.hpp"
+#include "thread_pool.hpp"
+#include "tree_generators.hpp"
+#include "visitors.hpp"
+
+namespace
+{
+    enum TreeShape
+    {
+        wide, // balanced
+        random, // random splits
+        deep // left-leaning chain - nothing to fork
+    };
+
+    AST::ExpressionNodePtr make_tree(TreeShape shape)
+    {
+        constexpr size_t leaf_count = 1 << 20;
+
+        switch (shape)
+        {
+        case wide:
+            return TreeGenerators::balanced_tree(leaf_count);
+        case random:
+        {
+            std::minstd_rand rng{42};
+            return TreeGenerators::random_tree(leaf_count, rng);
+        }
+        case deep:
+            return TreeGenerators::left_chain(leaf_count / 16);
+        }
+
+        return nullptr;
+    }
+
+    void shapes(benchmark::internal::Benchmark* bench)
+    {
+        bench->ArgName("shape")->DenseRange(wide, deep)->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+
+    void shapes_and_threads(benchmark::internal::Benchmark* bench)
+    {
+        const int max_threads = static_cast<int>(std::max(8u, std::thread::hardware_concurrency()));
+
+        bench->ArgNames({"shape", "threads"});
+        for (int shape = wide; shape <= deep; ++shape)
+        {
+            for (int threads = 1; threads <= max_threads; threads *= 2)
+                bench->Args({shape, threads});
+        }
+        bench->Unit(benchmark::kMillisecond)->UseRealTime();
+    }
+}
+
+// baseline - one thread, recursive visitor
+static void BM_ExprEvalVisitor_LargeTree(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<TreeShape>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        ExprEvalVisitor visitor;
+        expr->accept(visitor);
+        benchmark::DoNotOptimize(visitor.result());
+    }
+}
+BENCHMARK(BM_ExprEvalVisitor_LargeTree)->Apply(shapes);
+
+// speedup = time of BM_ExprEvalVisitor_LargeTree / time with a given number of threads
+static void BM_ParallelEvaluator(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<TreeShape>(state.range(0)));
+    WorkStealingPool pool{static_cast<size_t>(state.range(1))};
+    ParallelEvaluator evaluator{pool, *expr};
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(evaluator.evaluate());
+
+    state.counters["tasks"] = static_cast<double>(evaluator.sequential_task_count());
+}
+BENCHMARK(BM_ParallelEvaluator)->Apply(shapes_and_threads);
+
+// one-time cost - sizes of all subtrees are counted
+static void BM_ParallelEvaluator_Plan(benchmark::State& state)
+{
+    auto expr = make_tree(static_cast<TreeShape>(state.range(0)));
+    WorkStealingPool pool{1};
+
+    for (auto _ : state)
+    {
+        ParallelEvaluator evaluator{pool, *expr};
+        benchmark::DoNotOptimize(evaluator.sequential_task_count());
+    }
+}
+BENCHMARK(BM_ParallelEvaluator_Plan)->Apply(shapes);
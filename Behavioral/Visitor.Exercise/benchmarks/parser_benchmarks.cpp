@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <string_view>
+
+#include "flat_ast.hpp"
+#include "parser.hpp"
+#include "tree_generators.hpp"
+
+namespace
+{
+    constexpr size_t text_size = 1 << 20;
+
+    // formulas separated with new lines
+    const std::string& formulas()
+    {
+        static const std::string text = [] {
+            std::minstd_rand rng{42};
+            std::string text;
+            while (text.size() < text_size)
+            {
+                TreeGenerators::append_random_formula(text, rng, 6);
+                text += '\n';
+            }
+            return text;
+        }();
+
+        return text;
+    }
+
+    template <typename Function>
+    void for_each_line(std::string_view text, Function f)
+    {
+        while (!text.empty())
+        {
+            const size_t end = text.find('\n');
+            f(text.substr(0, end));
+            text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        }
+    }
+}
+
+// tokenizing alone - the upper bound of parsing throughput
+static void BM_Lexer(benchmark::State& state)
+{
+    const auto& text = formulas();
+
+    for (auto _ : state)
+    {
+        AST::Lexer lexer{text};
+        size_t count = 0;
+        while (lexer.next().kind != AST::Token::end)
+            ++count;
+        benchmark::DoNotOptimize(count);
+    }
+
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Lexer)->Unit(benchmark::kMillisecond);
+
+// every formula to a tree of nodes allocated one by one (freed when the next formula is parsed)
+static void BM_Parser_Tree(benchmark::State& state)
+{
+    const auto& text = formulas();
+    AST::Parser parser;
+
+    for (auto _ : state)
+    {
+        for_each_line(text, [&](std::string_view formula) {
+            auto expr = parser.parse(formula);
+            benchmark::DoNotOptimize(expr.get());
+        });
+    }
+
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_Parser_Tree)->Unit(benchmark::kMillisecond);
+
+// all formulas to one arena
+static void BM_Parser_FlatAst(benchmark::State& state)
+{
+    const auto& text = formulas();
+    AST::Parser parser;
+    AST::FlatAst ast;
+
+    for (auto _ : state)
+    {
+        ast.clear();
+        for_each_line(text, [&](std::string_view formula) {
+            benchmark::DoNotOptimize(parser.parse(formula, ast));
+        });
+    }
+
+    state.SetBytesProcessed(state.iterations() * text.size());
+    state.counters["nodes"] = static_cast<double>(ast.size());
+}
+BENCHMARK(BM_Parser_FlatAst)->Unit(benchmark::kMillisecond);
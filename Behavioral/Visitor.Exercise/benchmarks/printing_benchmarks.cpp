@@ -0,0 +1,144 @@
+#include <benchmark/benchmark.h>
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <utility>
+
+#include "tree_generators.hpp"
+#include "visitors.hpp"
+
+namespace
+{
+    constexpr size_t leaf_count = 5'000'000; // 10^7 nodes
+
+    enum TreeShape
+    {
+        wide, // balanced
+        deep // left-leaning chain
+    };
+
+    const AST::ExpressionNodePtr& tree(TreeShape shape)
+    {
+        static const auto wide_tree = TreeGenerators::balanced_tree(leaf_count);
+        static const auto deep_tree = TreeGenerators::left_chain(leaf_count);
+
+        return shape == wide ? wide_tree : deep_tree;
+    }
+
+    // counts and discards the text - measures printing, not the device
+    class NullBuffer : public std::streambuf
+    {
+    public:
+        size_t written{};
+
+    protected:
+        std::streamsize xsputn(const char*, std::streamsize count) override
+        {
+            written += static_cast<size_t>(count);
+            return count;
+        }
+
+        int overflow(int c) override
+        {
+            ++written;
+            return c;
+        }
+    };
+
+    // printer building the text of every subtree as a separate string
+    class ConcatenatingPrinter : public AST::AstVisitor
+    {
+        std::string text_;
+
+    public:
+        void visit(AST::AddNode& node) override
+        {
+            text_ = "(" + print(node.left()) + " + " + print(node.right()) + ")";
+        }
+
+        void visit(AST::MultiplyNode& node) override
+        {
+            text_ = "(" + print(node.left()) + " * " + print(node.right()) + ")";
+        }
+
+        void visit(AST::IntNode& node) override
+        {
+            text_ = std::to_string(node.value());
+        }
+
+        void visit(AST::VariableNode& node) override
+        {
+            text_ = "x" + std::to_string(node.index());
+        }
+
+        const std::string& str() const
+        {
+            return text_;
+        }
+
+    private:
+        static std::string print(AST::ExpressionNode& node)
+        {
+            ConcatenatingPrinter printer;
+            node.accept(printer);
+            return std::move(printer.text_);
+        }
+    };
+}
+
+// baseline - recursive, so only the balanced tree
+static void BM_ConcatenatingPrinter(benchmark::State& state)
+{
+    auto& expr = tree(wide);
+    size_t size = 0;
+
+    for (auto _ : state)
+    {
+        ConcatenatingPrinter printer;
+        expr->accept(printer);
+        size = printer.str().size();
+        benchmark::DoNotOptimize(printer.str().data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_ConcatenatingPrinter)->Unit(benchmark::kMillisecond);
+
+// whole text in the reused buffer of the visitor
+static void BM_PrintingVisitor_Buffer(benchmark::State& state)
+{
+    auto& expr = tree(static_cast<TreeShape>(state.range(0)));
+    PrintingVisitor printer{static_cast<PrintingVisitor::Parentheses>(state.range(1))};
+
+    for (auto _ : state)
+    {
+        printer.clear();
+        expr->accept(printer);
+        benchmark::DoNotOptimize(printer.str().data());
+    }
+
+    state.SetBytesProcessed(state.iterations() * printer.str().size());
+}
+BENCHMARK(BM_PrintingVisitor_Buffer)
+    ->ArgNames({"shape", "parentheses"})
+    ->ArgsProduct({{wide, deep}, {static_cast<int>(PrintingVisitor::Parentheses::full), static_cast<int>(PrintingVisitor::Parentheses::minimal)}})
+    ->Unit(benchmark::kMillisecond);
+
+// text written to a stream in 64 KB chunks
+static void BM_PrintingVisitor_Stream(benchmark::State& state)
+{
+    auto& expr = tree(static_cast<TreeShape>(state.range(0)));
+    NullBuffer buffer;
+    std::ostream out{&buffer};
+
+    for (auto _ : state)
+    {
+        PrintingVisitor printer{PrintingVisitor::Parentheses::minimal, &out};
+        expr->accept(printer);
+        printer.flush();
+    }
+
+    state.SetBytesProcessed(buffer.written);
+}
+BENCHMARK(BM_PrintingVisitor_Stream)->ArgNames({"shape"})->Arg(wide)->Arg(deep)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,131 @@
+#ifndef TREE_GENERATORS_HPP
+#define TREE_GENERATORS_HPP
+
+#include <cstddef>
+#include <random>
+#include <string>
+
+#include "ast.hpp"
+#include "flat_ast.hpp"
+
+// Expression trees used by benchmarks. Values stay small - results do not overflow an int.
+namespace TreeGenerators
+{
+    // leaf_count leaves (2 * leaf_count - 1 nodes); leaf pairs are multiplied, everything above is added
+    inline AST::ExpressionNodePtr balanced_tree(size_t leaf_count, size_t first_leaf = 0)
+    {
+        using namespace AST::helpers;
+
+        if (leaf_count == 1)
+            return integer(static_cast<int>(first_leaf % 3));
+
+        if (leaf_count == 2)
+            return multiply(integer(static_cast<int>(first_leaf % 3)), integer(2));
+
+        const size_t left_count = leaf_count / 2;
+        auto left = balanced_tree(left_count, first_leaf);
+        return add(std::move(left), balanced_tree(leaf_count - left_count, first_leaf + left_count));
+    }
+
+    // left-leaning chain of length additions and multiplications - as deep as it is long
+    inline AST::ExpressionNodePtr left_chain(size_t length)
+    {
+        using namespace AST::helpers;
+
+        AST::ExpressionNodePtr expr = integer(1);
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (i % 2 == 0)
+                expr = add(std::move(expr), integer(static_cast<int>(i % 3)));
+            else
+                expr = multiply(std::move(expr), integer(1));
+        }
+
+        return expr;
+    }
+
+    // leaves split between subtrees at random points - unbalanced, but O(log n) deep on average
+    inline AST::ExpressionNodePtr random_tree(size_t leaf_count, std::minstd_rand& rng)
+    {
+        using namespace AST::helpers;
+
+        if (leaf_count == 1)
+            return integer(static_cast<int>(rng() % 3));
+
+        const size_t left_count = 1 + rng() % (leaf_count - 1);
+        auto left = random_tree(left_count, rng);
+        auto right = random_tree(leaf_count - left_count, rng);
+
+        if (leaf_count == 2)
+            return multiply(std::move(left), std::move(right));
+
+        return add(std::move(left), std::move(right));
+    }
+
+    // balanced tree of leaf_count leaves - every variable_every-th leaf is one of variable_count
+    // variables, other leaves are constants. Subtrees repeat and the ones without variables are constant.
+    inline AST::ExpressionNodePtr formula(size_t leaf_count, size_t variable_count, size_t variable_every = 2, size_t first_leaf = 0)
+    {
+        using namespace AST::helpers;
+
+        if (leaf_count == 1)
+        {
+            if (first_leaf % variable_every == 0)
+                return variable(first_leaf / variable_every % variable_count);
+
+            return integer(static_cast<int>(first_leaf % 3));
+        }
+
+        const size_t left_count = leaf_count / 2;
+        auto left = formula(left_count, variable_count, variable_every, first_leaf);
+        auto right = formula(leaf_count - left_count, variable_count, variable_every, first_leaf + left_count);
+
+        if (leaf_count == 2)
+            return multiply(std::move(left), std::move(right));
+
+        return add(std::move(left), std::move(right));
+    }
+
+    // appends text of a random formula of integers, variables, + and * - parenthesized subexpressions included
+    inline void append_random_formula(std::string& text, std::minstd_rand& rng, int depth)
+    {
+        if (depth == 0 || rng() % 4 == 0)
+        {
+            if (rng() % 2 == 0)
+                text += std::to_string(rng() % 1000);
+            else
+                text += "x" + std::to_string(rng() % 8);
+            return;
+        }
+
+        const bool parenthesized = rng() % 3 == 0;
+        if (parenthesized)
+            text += '(';
+
+        append_random_formula(text, rng, depth - 1);
+        text += (rng() % 2 == 0) ? " + " : " * ";
+        append_random_formula(text, rng, depth - 1);
+
+        if (parenthesized)
+            text += ')';
+    }
+
+    // the same tree built directly in an arena
+    inline AST::NodeIndex balanced_tree(AST::FlatAst& ast, size_t leaf_count, size_t first_leaf = 0)
+    {
+        if (leaf_count == 1)
+            return ast.integer(static_cast<int>(first_leaf % 3));
+
+        if (leaf_count == 2)
+        {
+            const auto left = ast.integer(static_cast<int>(first_leaf % 3));
+            return ast.multiply(left, ast.integer(2));
+        }
+
+        const size_t left_count = leaf_count / 2;
+        const auto left = balanced_tree(ast, left_count, first_leaf);
+        return ast.add(left, balanced_tree(ast, leaf_count - left_count, first_leaf + left_count));
+    }
+}
+
+#endif // TREE_GENERATORS_HPP
@@ -1,8 +1,11 @@
 #ifndef AST_HPP
 #define AST_HPP
 
+#include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace AST
 {
@@ -10,6 +13,7 @@ namespace AST
     class AddNode;
     class MultiplyNode;
     class IntNode;
+    class VariableNode;
 
     using ExpressionNodePtr = std::unique_ptr<ExpressionNode>;
     using AddNodePtr = std::unique_ptr<AddNode>;
@@ -22,36 +26,107 @@ namespace AST
         virtual void visit(AddNode& node) = 0;
         virtual void visit(MultiplyNode& node) = 0;
         virtual void visit(IntNode& node) = 0;
+        virtual void visit(VariableNode& node) = 0;
     };
 
+    class BinaryExpression;
+
     class ExpressionNode
     {
     public:
         virtual void accept(AstVisitor& v) = 0;
         virtual ~ExpressionNode() = default;
+
+    protected:
+        // deletes the node with its subtrees - recursion goes at most levels deeper (see BinaryExpression)
+        virtual void destroy_subtree(size_t /*levels*/) noexcept
+        {
+            delete this;
+        }
+
+        // deletes the node and hands over its children - the left one in pending, the right one is returned
+        virtual ExpressionNode* dismantle(ExpressionNode*& pending) noexcept
+        {
+            pending = nullptr;
+            delete this;
+            return nullptr;
+        }
+
+        // binary nodes are told from leaves by this in trees too deep for recursion
+        virtual BinaryExpression* as_binary() noexcept
+        {
+            return nullptr;
+        }
+
+        void destroy_children(size_t /*levels*/) noexcept
+        {
+        }
+
+        ExpressionNode* release_children(ExpressionNode*& pending) noexcept
+        {
+            pending = nullptr;
+            return nullptr;
+        }
+
+        friend class BinaryExpression;
     };
 
     // CRTP for accept implementation in derived classes
-    template <typename ExpressionType>
-    class VisitableExpression : public ExpressionNode
+    template <typename ExpressionType, typename Base = ExpressionNode>
+    class VisitableExpression : public Base
     {
     public:
+        using Base::Base;
+
         void accept(AstVisitor& v)
         {
             v.visit(static_cast<ExpressionType&>(*this));
         }
+
+    protected:
+        // one virtual call per node - the node is deleted with its static type
+        void destroy_subtree(size_t levels) noexcept override
+        {
+            Base::destroy_children(levels);
+            delete static_cast<ExpressionType*>(this);
+        }
+
+        ExpressionNode* dismantle(ExpressionNode*& pending) noexcept override
+        {
+            ExpressionNode* left;
+            ExpressionNode* right = Base::release_children(left);
+            delete static_cast<ExpressionType*>(this);
+            pending = left;
+            return right;
+        }
     };
 
-    class AddNode : public VisitableExpression<AddNode>
+    // Node owning two subtrees. The top max_destruction_depth levels of a tree are destroyed
+    // recursively - the remaining depth is passed down, so the fast path costs no more than
+    // recursive destructors. Deeper subtrees are destroyed in a loop - a node is deleted before
+    // its subtrees, left subtrees wait in a fixed array and, once it is full, are rotated into
+    // right ones. The depth of a tree is not limited by the size of the thread stack and
+    // teardown does not allocate.
+    class BinaryExpression : public ExpressionNode
     {
         ExpressionNodePtr left_;
         ExpressionNodePtr right_;
 
     public:
-        AddNode(ExpressionNodePtr left, ExpressionNodePtr right) : left_{std::move(left)}, right_{std::move(right)}
+        static constexpr size_t max_destruction_depth = 256;
+
+        BinaryExpression(ExpressionNodePtr left, ExpressionNodePtr right) : left_{std::move(left)}, right_{std::move(right)}
         {
         }
 
+        BinaryExpression(const BinaryExpression&) = delete;
+        BinaryExpression& operator=(const BinaryExpression&) = delete;
+
+        ~BinaryExpression() override
+        {
+            destroy_children(max_destruction_depth);
+        }
+
         ExpressionNode& left()
         {
             return *left_;
@@ -61,30 +136,128 @@ namespace AST
         {
             return *right_;
         }
-    };
 
-    class MultiplyNode : public VisitableExpression<MultiplyNode>
-    {
-        ExpressionNodePtr left_;
-        ExpressionNodePtr right_;
+    protected:
+        void destroy_subtree(size_t levels) noexcept override
+        {
+            destroy_children(levels);
+            delete this;
+        }
 
-    public:
-        MultiplyNode(ExpressionNodePtr left, ExpressionNodePtr right) : left_{std::move(left)}, right_{std::move(right)}
+        ExpressionNode* dismantle(ExpressionNode*& pending) noexcept override
         {
+            ExpressionNode* left;
+            ExpressionNode* right = release_children(left);
+            delete this;
+            pending = left;
+            return right;
         }
 
-        ExpressionNode& left()
+        ExpressionNode* release_children(ExpressionNode*& pending) noexcept
         {
-            return *left_;
+            pending = left_.release();
+            return right_.release();
         }
 
-        ExpressionNode& right()
+        BinaryExpression* as_binary() noexcept final
         {
-            return *right_;
+            return this;
+        }
+
+        // right before left - in the order of members destruction
+        void destroy_children(size_t levels) noexcept
+        {
+            if (levels == 0)
+            {
+                destroy_deep(*this);
+                return;
+            }
+
+            if (right_)
+                right_.release()->destroy_subtree(levels - 1);
+            if (left_)
+                left_.release()->destroy_subtree(levels - 1);
         }
+
+    private:
+        static constexpr size_t max_pending = 64;
+
+        // nodes are deleted before their subtrees, left subtrees wait in an array
+        static void destroy_deep(BinaryExpression& root) noexcept
+        {
+            ExpressionNode* pending[max_pending];
+            ExpressionNode* node = root.release_children(pending[0]);
+            size_t pending_count = (pending[0] != nullptr);
+
+            while (true)
+            {
+                while (node)
+                {
+                    if (pending_count == max_pending)
+                    {
+                        destroy_rotating(node);
+                        break;
+                    }
+
+                    node = node->dismantle(pending[pending_count]);
+                    if (pending[pending_count])
+                        ++pending_count;
+                }
+
+                if (pending_count == 0)
+                    return;
+
+                node = pending[--pending_count];
+            }
+        }
+
+        // left subtrees are rotated into right ones - a node is deleted once its left child is a leaf
+        static void destroy_rotating(ExpressionNode* node) noexcept
+        {
+            while (node)
+            {
+                BinaryExpression* binary = node->as_binary();
+                if (!binary)
+                {
+                    delete node;
+                    return;
+                }
+
+                while (binary->left_)
+                {
+                    BinaryExpression* left = binary->left_->as_binary();
+                    if (!left)
+                    {
+                        binary->left_.reset();
+                        break;
+                    }
+
+                    // (a x b) y c -> a x (b y c)
+                    binary->left_.release();
+                    binary->left_ = std::move(left->right_);
+                    left->right_.reset(binary);
+                    binary = left;
+                }
+
+                node = binary->right_.release();
+                delete binary;
+            }
+        }
+    };
+
+    class AddNode final : public VisitableExpression<AddNode, BinaryExpression>
+    {
+    public:
+        using VisitableExpression::VisitableExpression;
+    };
+
+    class MultiplyNode final : public VisitableExpression<MultiplyNode, BinaryExpression>
+    {
+    public:
+        using VisitableExpression::VisitableExpression;
     };
 
-    class IntNode : public VisitableExpression<IntNode>
+    class IntNode final : public VisitableExpression<IntNode>
     {
         int value_;
 
@@ -99,22 +272,93 @@ namespace AST
         }
     };
 
+    // Input of an expression - index of a value in a row of variables (a column of a table)
+    class VariableNode final : public VisitableExpression<VariableNode>
+    {
+        size_t index_;
+
+    public:
+        VariableNode(size_t index) : index_{index}
+        {
+        }
+
+        size_t index() const
+        {
+            return index_;
+        }
+    };
+
+    // value of the variable index in a row - variables is nullptr for expressions without variables
+    inline int variable_value(const std::vector<int>* variables, size_t index)
+    {
+        if (!variables || index >= variables->size())
+            throw std::out_of_range("No value of variable " + std::to_string(index));
+
+        return (*variables)[index];
+    }
+
+    // Arithmetic of all evaluators and of constant folding - wraps around on overflow.
+    // Computed on unsigned values, so an overflow is defined and gives the same result everywhere.
+    inline int wrapping_add(int left, int right)
+    {
+        return static_cast<int>(static_cast<uint32_t>(left) + static_cast<uint32_t>(right));
+    }
+
+    inline int wrapping_multiply(int left, int right)
+    {
+        return static_cast<int>(static_cast<uint32_t>(left) * static_cast<uint32_t>(right));
+    }
+
     namespace helpers
     {
-        AddNodePtr add(ExpressionNodePtr left, ExpressionNodePtr right)
+        inline AddNodePtr add(ExpressionNodePtr left, ExpressionNodePtr right)
         {
             return std::make_unique<AddNode>(std::move(left), std::move(right));
         }
 
-        ExpressionNodePtr integer(int value)
+        inline ExpressionNodePtr integer(int value)
         {
             return std::make_unique<IntNode>(value);
         }
 
-        MultiplyNodePtr multiply(ExpressionNodePtr left, ExpressionNodePtr right)
+        inline MultiplyNodePtr multiply(ExpressionNodePtr left, ExpressionNodePtr right)
         {
             return std::make_unique<MultiplyNode>(std::move(left), std::move(right));
         }
+
+        inline ExpressionNodePtr variable(size_t index)
+        {
+            return std::make_unique<VariableNode>(index);
+        }
+    }
+
+    namespace Details
+    {
+        // creates nodes of a tree with helpers - used by parsers and loaders
+        struct TreeNodeFactory
+        {
+            using Node = ExpressionNodePtr;
+
+            Node integer(int value)
+            {
+                return helpers::integer(value);
+            }
+
+            Node variable(uint32_t index)
+            {
+                return helpers::variable(index);
+            }
+
+            Node add(Node left, Node right)
+            {
+                return helpers::add(std::move(left), std::move(right));
+            }
+
+            Node multiply(Node left, Node right)
+            {
+                return helpers::multiply(std::move(left), std::move(right));
+            }
+        };
     }
 }
 
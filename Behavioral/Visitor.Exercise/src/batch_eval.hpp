@@ -0,0 +1,89 @@
+#ifndef BATCH_EVAL_HPP
+#define BATCH_EVAL_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "ast.hpp"
+#include "bytecode.hpp"
+
+// Evaluates one expression for many rows of variables stored in columns. The tree is walked
+// once (compiled to bytecode), then rows are processed in chunks - every instruction is applied
+// to a whole chunk in a plain loop the compiler vectorizes. Nothing is dispatched per row.
+class BatchEvaluator
+{
+    BytecodeProgram program_;
+    std::vector<int> stack_; // max_stack_depth slots (at most log2(leaves) + 1), each holding values of a chunk
+
+public:
+    // multiple of the widest SIMD register (16 ints) - a slot of the stack stays in L1 cache
+    static constexpr size_t chunk_size = 256;
+
+    explicit BatchEvaluator(AST::ExpressionNode& expr)
+        : program_{BytecodeCompiler::compile(expr)}
+        , stack_(program_.max_stack_depth() * chunk_size)
+    {
+    }
+
+    const BytecodeProgram& program() const
+    {
+        return program_;
+    }
+
+    // columns[i] points to row_count values of the variable i, output receives row_count results
+    void evaluate(const std::vector<const int*>& columns, size_t row_count, int* output)
+    {
+        if (columns.size() < program_.variable_count())
+            throw std::out_of_range("No columns for variables of the expression");
+
+        for (size_t first_row = 0; first_row < row_count; first_row += chunk_size)
+            evaluate_chunk(columns, first_row, std::min(chunk_size, row_count - first_row), output + first_row);
+    }
+
+private:
+    void evaluate_chunk(const std::vector<const int*>& columns, size_t first_row, size_t count, int* output)
+    {
+        assert(!program_.code().empty());
+
+        int* top = stack_.data(); // one past the top slot
+        const int* constant = program_.constants().data();
+
+        for (OpCode op : program_.code())
+        {
+            switch (op)
+            {
+            case OpCode::push:
+                std::fill_n(top, count, *constant++);
+                top += chunk_size;
+                break;
+            case OpCode::load:
+                std::copy_n(columns[*constant++] + first_row, count, top);
+                top += chunk_size;
+                break;
+            case OpCode::add:
+            {
+                top -= chunk_size;
+                int* lhs = top - chunk_size;
+                for (size_t i = 0; i < count; ++i)
+                    lhs[i] = AST::wrapping_add(lhs[i], top[i]);
+                break;
+            }
+            case OpCode::multiply:
+            {
+                top -= chunk_size;
+                int* lhs = top - chunk_size;
+                for (size_t i = 0; i < count; ++i)
+                    lhs[i] = AST::wrapping_multiply(lhs[i], top[i]);
+                break;
+            }
+            }
+        }
+
+        std::copy_n(top - chunk_size, count, output);
+    }
+};
+
+#endif // BATCH_EVAL_HPP
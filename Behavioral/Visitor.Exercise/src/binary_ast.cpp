@@ -0,0 +1,228 @@
+#include "binary_ast.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    using namespace AST;
+
+    [[noreturn]] void throw_corrupted(size_t offset)
+    {
+        throw std::runtime_error("AST data is corrupted at offset " + std::to_string(offset));
+    }
+
+    void put_varint(std::string& out, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    constexpr uint32_t tag_bits = 2;
+    constexpr uint32_t varint_payload = 63; // payload of a record followed by a varint
+
+    // leaf record with a payload inlined if it is small
+    void put_leaf(std::string& out, BinaryTag tag, uint32_t payload)
+    {
+        const uint32_t inlined = std::min(payload, varint_payload);
+        out += static_cast<char>(static_cast<uint32_t>(tag) | inlined << tag_bits);
+
+        if (inlined == varint_payload)
+            put_varint(out, payload);
+    }
+
+    // base - offset of data in the whole buffer
+    uint32_t read_varint(std::string_view data, size_t& pos, size_t base)
+    {
+        uint32_t value = 0;
+        for (int shift = 0; shift < 35; shift += 7)
+        {
+            if (pos == data.size())
+                throw_corrupted(base + pos);
+
+            const auto byte = static_cast<uint8_t>(data[pos++]);
+            if (shift == 28 && byte > 0x0F) // the 5th byte holds the top 4 bits of 32
+                throw_corrupted(base + pos - 1);
+
+            value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+
+        throw_corrupted(base + pos);
+    }
+
+    // small negative numbers are encoded in few bytes too
+    uint32_t zigzag(int value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int unzigzag(uint32_t value)
+    {
+        return static_cast<int>((value >> 1) ^ (0u - (value & 1)));
+    }
+
+    // "builds" values of nodes - wraps around on overflow, any stored expression can be evaluated
+    struct Evaluator
+    {
+        using Node = int;
+
+        const std::vector<int>* variables;
+
+        int integer(int value)
+        {
+            return value;
+        }
+
+        int variable(uint32_t index)
+        {
+            return variable_value(variables, index);
+        }
+
+        int add(int left, int right)
+        {
+            return wrapping_add(left, right);
+        }
+
+        int multiply(int left, int right)
+        {
+            return wrapping_multiply(left, right);
+        }
+    };
+
+    // single pass over records of one expression with a stack of nodes of finished subtrees
+    template <typename Builder>
+    typename Builder::Node decode(std::string_view records, size_t offset, Builder& builder, std::vector<typename Builder::Node>& stack)
+    {
+        stack.clear();
+
+        size_t pos = 0;
+        while (pos < records.size())
+        {
+            const size_t record_offset = offset + pos;
+            const auto byte = static_cast<uint8_t>(records[pos++]);
+            const auto tag = static_cast<BinaryTag>(byte & ((1u << tag_bits) - 1));
+            const uint32_t payload = byte >> tag_bits;
+
+            switch (tag)
+            {
+            case BinaryTag::integer:
+                stack.push_back(builder.integer(unzigzag(payload == varint_payload ? read_varint(records, pos, offset) : payload)));
+                break;
+            case BinaryTag::variable:
+                stack.push_back(builder.variable(payload == varint_payload ? read_varint(records, pos, offset) : payload));
+                break;
+            case BinaryTag::add:
+            case BinaryTag::multiply:
+            {
+                if (payload != 0 || stack.size() < 2)
+                    throw_corrupted(record_offset);
+
+                auto right = std::move(stack.back());
+                stack.pop_back();
+                auto& left = stack.back();
+                left = (tag == BinaryTag::add) ? builder.add(std::move(left), std::move(right)) : builder.multiply(std::move(left), std::move(right));
+                break;
+            }
+            }
+        }
+
+        if (stack.size() != 1)
+            throw_corrupted(offset);
+
+        return std::move(stack.back());
+    }
+}
+
+void AST::BinaryAstWriter::write(ExpressionNode& expr)
+{
+    records_.clear();
+    expr.accept(*this);
+
+    if (records_.size() > UINT32_MAX)
+        throw std::length_error("Expression does not fit the binary format");
+
+    put_varint(data_, static_cast<uint32_t>(records_.size()));
+    data_ += records_;
+}
+
+void AST::BinaryAstWriter::save(const std::string& file_path) const
+{
+    std::ofstream file{file_path, std::ios::binary | std::ios::trunc};
+    file.write(data_.data(), static_cast<std::streamsize>(data_.size()));
+
+    if (!file)
+        throw std::runtime_error("Writing AST file failed: " + file_path);
+}
+
+void AST::BinaryAstWriter::visit(AddNode& node)
+{
+    node.left().accept(*this);
+    node.right().accept(*this);
+    records_ += static_cast<char>(BinaryTag::add);
+}
+
+void AST::BinaryAstWriter::visit(MultiplyNode& node)
+{
+    node.left().accept(*this);
+    node.right().accept(*this);
+    records_ += static_cast<char>(BinaryTag::multiply);
+}
+
+void AST::BinaryAstWriter::visit(IntNode& node)
+{
+    put_leaf(records_, BinaryTag::integer, zigzag(node.value()));
+}
+
+void AST::BinaryAstWriter::visit(VariableNode& node)
+{
+    if (node.index() > UINT32_MAX)
+        throw std::out_of_range("Variable index does not fit the binary format");
+
+    put_leaf(records_, BinaryTag::variable, static_cast<uint32_t>(node.index()));
+}
+
+int AST::SerializedExpression::evaluate(std::vector<int>& stack, const std::vector<int>* variables) const
+{
+    Evaluator evaluator{variables};
+    return decode(records_, offset_, evaluator, stack);
+}
+
+AST::ExpressionNodePtr AST::SerializedExpression::build() const
+{
+    Details::TreeNodeFactory builder;
+    std::vector<ExpressionNodePtr> stack;
+    return decode(records_, offset_, builder, stack);
+}
+
+AST::NodeIndex AST::SerializedExpression::build(FlatAst& ast) const
+{
+    Details::FlatNodeFactory builder{ast};
+    std::vector<NodeIndex> stack;
+    return decode(records_, offset_, builder, stack);
+}
+
+AST::BinaryAstView::BinaryAstView(std::string_view data)
+    : data_{data}
+{
+    if (data_.substr(0, binary_ast_magic.size()) != binary_ast_magic)
+        throw std::runtime_error("Not an AST file - header does not match");
+}
+
+size_t AST::BinaryAstView::read_size(size_t& pos) const
+{
+    const size_t size_offset = pos;
+    const size_t size = read_varint(data_, pos, 0);
+
+    if (size > data_.size() - pos)
+        throw_corrupted(size_offset);
+
+    return size;
+}
@@ -0,0 +1,135 @@
+#ifndef BINARY_AST_HPP
+#define BINARY_AST_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ast.hpp"
+#include "flat_ast.hpp"
+#include "mapped_file.hpp"
+
+// Compact binary format of expressions:
+//   file:       magic "ASTBIN01", expressions one after another
+//   expression: varint size of its records in bytes, records in postfix order
+//   record:     byte with a tag in the low 2 bits and a payload in the high 6 bits - the index
+//               of a variable or the zigzag-encoded value of an integer; a payload of 63 means
+//               that the index or value follows as a varint
+// Sizes let a reader skip expressions without decoding them.
+namespace AST
+{
+    enum class BinaryTag : uint8_t
+    {
+        integer,
+        variable,
+        add,
+        multiply
+    };
+
+    inline constexpr std::string_view binary_ast_magic{"ASTBIN01"};
+
+    // Visitor writing trees to a buffer in the binary format - one tree per write()
+    class BinaryAstWriter : public AstVisitor
+    {
+        std::string data_{binary_ast_magic};
+        std::string records_; // of the expression being written
+
+    public:
+        void write(ExpressionNode& expr);
+
+        // serialized expressions with the header
+        const std::string& data() const
+        {
+            return data_;
+        }
+
+        void save(const std::string& file_path) const;
+
+        void visit(AddNode& node) override;
+        void visit(MultiplyNode& node) override;
+        void visit(IntNode& node) override;
+        void visit(VariableNode& node) override;
+    };
+
+    // One expression inside a buffer - its nodes are decoded only when it is evaluated or built
+    class SerializedExpression
+    {
+        std::string_view records_;
+        size_t offset_; // of records in the buffer - reported when data is corrupted
+
+    public:
+        SerializedExpression(std::string_view records, size_t offset)
+            : records_{records}
+            , offset_{offset}
+        {
+        }
+
+        std::string_view records() const
+        {
+            return records_;
+        }
+
+        // evaluates records in place - stack is reused by subsequent calls
+        int evaluate(std::vector<int>& stack, const std::vector<int>* variables = nullptr) const;
+
+        ExpressionNodePtr build() const;
+
+        // appends nodes to ast - returns the index of the root
+        NodeIndex build(FlatAst& ast) const;
+    };
+
+    // Expressions stored in a buffer (e.g. a mapped file) - the buffer must outlive the view.
+    // Creating a view checks only the header.
+    class BinaryAstView
+    {
+        std::string_view data_;
+
+    public:
+        explicit BinaryAstView(std::string_view data);
+
+        std::string_view data() const
+        {
+            return data_;
+        }
+
+        // calls f(const SerializedExpression&) for every expression
+        template <typename Function>
+        void for_each(Function f) const
+        {
+            size_t pos = binary_ast_magic.size();
+            while (pos < data_.size())
+            {
+                const size_t size = read_size(pos);
+                f(SerializedExpression{data_.substr(pos, size), pos});
+                pos += size;
+            }
+        }
+
+    private:
+        // reads the size of the next expression - pos is moved to its records
+        size_t read_size(size_t& pos) const;
+    };
+
+    // File of serialized expressions - opening it costs the mapping, expressions are decoded on use
+    class MappedAstFile
+    {
+        MappedFile file_;
+        BinaryAstView expressions_;
+
+    public:
+        explicit MappedAstFile(const std::string& file_path)
+            : file_{file_path}
+            , expressions_{file_.data()}
+        {
+        }
+
+        const BinaryAstView& expressions() const
+        {
+            return expressions_;
+        }
+    };
+}
+
+#endif // BINARY_AST_HPP
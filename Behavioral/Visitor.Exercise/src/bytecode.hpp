@@ -0,0 +1,261 @@
+#ifndef BYTECODE_HPP
+#define BYTECODE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ast.hpp"
+
+enum class OpCode : uint8_t
+{
+    push, // pushes the next constant
+    load, // pushes the variable indexed by the next constant
+    add,
+    multiply
+};
+
+// Expression lowered to postfix code for a stack machine - compiled once, evaluated many times
+class BytecodeProgram
+{
+    std::vector<OpCode> code_;
+    std::vector<int> constants_; // operands of push & load instructions in order of execution
+    size_t max_stack_depth_{};
+    size_t variable_count_{}; // highest index of a loaded variable + 1
+
+    friend class BytecodeCompiler;
+
+public:
+    // stack is reused by subsequent runs - no allocation once it is large enough;
+    // variables - values of variables of the expression (indexed by VariableNode::index())
+    int run(std::vector<int>& stack, const std::vector<int>* variables = nullptr) const
+    {
+        if (code_.empty())
+            return 0;
+
+        if (variable_count_ > 0 && (!variables || variables->size() < variable_count_))
+            throw std::out_of_range("No values of variables of the program");
+
+        if (stack.size() < max_stack_depth_)
+            stack.resize(max_stack_depth_);
+
+        int* top = stack.data(); // one past the top value
+        const int* constant = constants_.data();
+
+        for (OpCode op : code_)
+        {
+            switch (op)
+            {
+            case OpCode::push:
+                *top++ = *constant++;
+                break;
+            case OpCode::load:
+                *top++ = (*variables)[*constant++];
+                break;
+            case OpCode::add:
+                --top;
+                top[-1] = AST::wrapping_add(top[-1], *top);
+                break;
+            case OpCode::multiply:
+                --top;
+                top[-1] = AST::wrapping_multiply(top[-1], *top);
+                break;
+            }
+        }
+
+        return top[-1];
+    }
+
+    int run(const std::vector<int>* variables = nullptr) const
+    {
+        std::vector<int> stack;
+        return run(stack, variables);
+    }
+
+    const std::vector<OpCode>& code() const
+    {
+        return code_;
+    }
+
+    const std::vector<int>& constants() const
+    {
+        return constants_;
+    }
+
+    size_t max_stack_depth() const
+    {
+        return max_stack_depth_;
+    }
+
+    size_t variable_count() const
+    {
+        return variable_count_;
+    }
+};
+
+// Visitor lowering a tree to a BytecodeProgram - one pass, children before their parent.
+// Of the two operands of + and * (both commutative) the one needing a deeper stack is emitted
+// first, the other one is evaluated on top of its result - so the stack of a program grows
+// at most to log2(number of leaves) + 1 for any shape of a tree (Sethi-Ullman order).
+// Subtrees are measured before code is emitted - compile() is the only way to use a compiler.
+class BytecodeCompiler : public AST::AstVisitor
+{
+    struct Subtree
+    {
+        size_t size; // number of nodes
+        size_t stack_depth; // needed to evaluate it
+    };
+
+    // measures subtrees in post-order - a node follows its right child, which follows its left subtree
+    class SubtreeMeasure : public AST::AstVisitor
+    {
+        std::vector<Subtree>& subtrees_;
+
+    public:
+        explicit SubtreeMeasure(std::vector<Subtree>& subtrees)
+            : subtrees_{subtrees}
+        {
+        }
+
+        void visit(AST::AddNode& node) override
+        {
+            measure_binary(node.left(), node.right());
+        }
+
+        void visit(AST::MultiplyNode& node) override
+        {
+            measure_binary(node.left(), node.right());
+        }
+
+        void visit(AST::IntNode&) override
+        {
+            subtrees_.push_back(Subtree{1, 1});
+        }
+
+        void visit(AST::VariableNode&) override
+        {
+            subtrees_.push_back(Subtree{1, 1});
+        }
+
+    private:
+        void measure_binary(AST::ExpressionNode& left, AST::ExpressionNode& right)
+        {
+            left.accept(*this);
+            const Subtree left_subtree = subtrees_.back();
+            right.accept(*this);
+            const Subtree right_subtree = subtrees_.back();
+
+            const size_t stack_depth = (left_subtree.stack_depth == right_subtree.stack_depth)
+                ? left_subtree.stack_depth + 1
+                : std::max(left_subtree.stack_depth, right_subtree.stack_depth);
+
+            subtrees_.push_back(Subtree{left_subtree.size + right_subtree.size + 1, stack_depth});
+        }
+    };
+
+    BytecodeProgram program_;
+    std::vector<Subtree> subtrees_;
+    size_t node_{}; // post-order index of the visited node in subtrees_
+    size_t depth_{};
+
+    BytecodeCompiler() = default;
+
+public:
+    static BytecodeProgram compile(AST::ExpressionNode& expr)
+    {
+        BytecodeCompiler compiler;
+        compiler.measure(expr);
+        expr.accept(compiler);
+
+        return compiler.release();
+    }
+
+private:
+    void visit(AST::AddNode& node) override
+    {
+        emit_operands(node.left(), node.right());
+        emit_binary(OpCode::add);
+    }
+
+    void visit(AST::MultiplyNode& node) override
+    {
+        emit_operands(node.left(), node.right());
+        emit_binary(OpCode::multiply);
+    }
+
+    void visit(AST::IntNode& node) override
+    {
+        emit_leaf(OpCode::push, node.value());
+    }
+
+    void visit(AST::VariableNode& node) override
+    {
+        if (node.index() >= static_cast<size_t>(INT32_MAX))
+            throw std::out_of_range("Too many variables for bytecode");
+
+        emit_leaf(OpCode::load, static_cast<int>(node.index()));
+
+        if (node.index() >= program_.variable_count_)
+            program_.variable_count_ = node.index() + 1;
+    }
+
+    BytecodeProgram release()
+    {
+        program_.code_.shrink_to_fit();
+        program_.constants_.shrink_to_fit();
+
+        return std::move(program_);
+    }
+
+    void measure(AST::ExpressionNode& expr)
+    {
+        SubtreeMeasure measure{subtrees_};
+        expr.accept(measure);
+
+        node_ = subtrees_.size() - 1;
+    }
+
+    void emit_operands(AST::ExpressionNode& left, AST::ExpressionNode& right)
+    {
+        const size_t right_node = node_ - 1;
+        const size_t left_node = right_node - subtrees_[right_node].size;
+
+        if (subtrees_[left_node].stack_depth >= subtrees_[right_node].stack_depth)
+        {
+            emit_operand(left, left_node);
+            emit_operand(right, right_node);
+        }
+        else
+        {
+            emit_operand(right, right_node);
+            emit_operand(left, left_node);
+        }
+    }
+
+    void emit_operand(AST::ExpressionNode& operand, size_t node)
+    {
+        node_ = node;
+        operand.accept(*this);
+    }
+
+    void emit_leaf(OpCode op, int operand)
+    {
+        program_.code_.push_back(op);
+        program_.constants_.push_back(operand);
+
+        ++depth_;
+        if (depth_ > program_.max_stack_depth_)
+            program_.max_stack_depth_ = depth_;
+    }
+
+    void emit_binary(OpCode op)
+    {
+        program_.code_.push_back(op);
+        --depth_; // two operands replaced by a result
+    }
+};
+
+#endif // BYTECODE_HPP
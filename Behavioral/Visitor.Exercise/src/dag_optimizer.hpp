@@ -0,0 +1,169 @@
+#ifndef DAG_OPTIMIZER_HPP
+#define DAG_OPTIMIZER_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "ast.hpp"
+#include "flat_ast.hpp"
+
+// Visitor copying a tree to a FlatAst DAG - subtrees without variables are folded to constants
+// and structurally identical subtrees are stored once (hash-consing). Evaluation of the DAG
+// computes every unique subexpression once.
+class DagOptimizer : public AST::AstVisitor
+{
+    using NodeKind = AST::FlatAst::NodeKind;
+
+    struct NodeKey
+    {
+        NodeKind kind;
+        uint32_t first; // value, variable or left child
+        uint32_t second; // right child
+
+        bool operator==(const NodeKey& other) const
+        {
+            return kind == other.kind && first == other.first && second == other.second;
+        }
+    };
+
+    struct NodeKeyHash
+    {
+        size_t operator()(const NodeKey& key) const
+        {
+            const uint64_t bits = (static_cast<uint64_t>(key.first) << 32 | key.second) ^ static_cast<uint64_t>(key.kind) << 61;
+            return static_cast<size_t>((bits * 0x9E3779B97F4A7C15ull) >> 16);
+        }
+    };
+
+    // value of the last visited subtree - constants are added to the DAG only when needed,
+    // so folded subtrees leave no dead nodes
+    struct Subtree
+    {
+        bool is_constant;
+        int value; // constant
+        AST::NodeIndex index; // otherwise
+    };
+
+    AST::FlatAst dag_;
+    std::unordered_map<NodeKey, AST::NodeIndex, NodeKeyHash> unique_nodes_;
+    Subtree last_{};
+    size_t tree_size_{};
+
+public:
+    static AST::FlatAst optimize(AST::ExpressionNode& expr)
+    {
+        DagOptimizer optimizer;
+        expr.accept(optimizer);
+
+        return optimizer.release();
+    }
+
+    void visit(AST::AddNode& node) override
+    {
+        visit_binary(node, NodeKind::add);
+    }
+
+    void visit(AST::MultiplyNode& node) override
+    {
+        visit_binary(node, NodeKind::multiply);
+    }
+
+    void visit(AST::IntNode& node) override
+    {
+        ++tree_size_;
+        last_ = Subtree{true, node.value(), 0};
+    }
+
+    void visit(AST::VariableNode& node) override
+    {
+        if (node.index() > UINT32_MAX)
+            throw std::out_of_range("Variable index does not fit FlatAst");
+
+        ++tree_size_;
+        const auto index = static_cast<uint32_t>(node.index());
+        last_ = Subtree{false, 0, intern(NodeKey{NodeKind::variable, index, 0}, [&] { return dag_.variable(index); })};
+    }
+
+    // number of nodes of the visited tree
+    size_t tree_size() const
+    {
+        return tree_size_;
+    }
+
+    // moves out the DAG of the visited tree - its root is the last node
+    AST::FlatAst release()
+    {
+        if (last_.is_constant)
+            materialize(last_);
+
+        assert(dag_.empty() || dag_.root() == last_.index);
+
+        unique_nodes_.clear();
+        last_ = Subtree{};
+        tree_size_ = 0;
+        return std::exchange(dag_, AST::FlatAst{});
+    }
+
+private:
+    template <typename Node>
+    void visit_binary(Node& node, NodeKind kind)
+    {
+        ++tree_size_;
+
+        node.left().accept(*this);
+        Subtree left = last_;
+        node.right().accept(*this);
+        Subtree right = last_;
+
+        if (left.is_constant && right.is_constant)
+        {
+            last_ = Subtree{true, fold(kind, left.value, right.value), 0};
+            return;
+        }
+
+        AST::NodeIndex left_index = materialize(left);
+        AST::NodeIndex right_index = materialize(right);
+
+        // addition and multiplication are commutative - a + b and b + a share one node
+        if (left_index > right_index)
+            std::swap(left_index, right_index);
+
+        last_ = Subtree{false, 0, intern(NodeKey{kind, left_index, right_index}, [&] {
+                            return kind == NodeKind::add ? dag_.add(left_index, right_index) : dag_.multiply(left_index, right_index);
+                        })};
+    }
+
+    // the same arithmetic as the evaluators - a folded constant equals the evaluated subtree
+    static int fold(NodeKind kind, int left, int right)
+    {
+        return kind == NodeKind::add ? AST::wrapping_add(left, right) : AST::wrapping_multiply(left, right);
+    }
+
+    AST::NodeIndex materialize(Subtree& subtree)
+    {
+        if (subtree.is_constant)
+        {
+            const int value = subtree.value;
+            subtree = Subtree{false, 0, intern(NodeKey{NodeKind::integer, static_cast<uint32_t>(value), 0}, [&] { return dag_.integer(value); })};
+        }
+
+        return subtree.index;
+    }
+
+    // index of the node equal to key - make_node adds it to the DAG when it is seen first
+    template <typename MakeNode>
+    AST::NodeIndex intern(const NodeKey& key, MakeNode make_node)
+    {
+        auto [it, inserted] = unique_nodes_.try_emplace(key, 0);
+        if (inserted)
+            it->second = make_node();
+
+        return it->second;
+    }
+};
+
+#endif // DAG_OPTIMIZER_HPP
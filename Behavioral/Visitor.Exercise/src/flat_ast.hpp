@@ -0,0 +1,380 @@
+#ifndef FLAT_AST_HPP
+#define FLAT_AST_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "ast.hpp"
+
+namespace AST
+{
+    using NodeIndex = uint32_t;
+
+    class FlatAst;
+
+    namespace Details
+    {
+        // Free list of fixed-size blocks for short-lived nodes - a block is reused
+        // by the next allocation, so walking a tree does not touch the global heap.
+        template <size_t BlockSize>
+        class BlockPool
+        {
+            union Block
+            {
+                Block* next;
+                alignas(std::max_align_t) unsigned char storage[BlockSize];
+            };
+
+            Block* free_{};
+
+        public:
+            BlockPool() = default;
+            BlockPool(const BlockPool&) = delete;
+            BlockPool& operator=(const BlockPool&) = delete;
+
+            ~BlockPool()
+            {
+                while (free_)
+                    delete std::exchange(free_, free_->next);
+            }
+
+            void* allocate()
+            {
+                if (!free_)
+                    return new Block;
+
+                return std::exchange(free_, free_->next);
+            }
+
+            void deallocate(void* ptr) noexcept
+            {
+                auto* block = static_cast<Block*>(ptr);
+                block->next = free_;
+                free_ = block;
+            }
+        };
+
+        // child of a node materialized from a FlatAst - accept() continues the walk in the arena
+        class FlatNodeRef : public ExpressionNode
+        {
+            static constexpr size_t block_size = sizeof(void*) * 3;
+
+            const FlatAst& ast_;
+            NodeIndex index_;
+
+            static BlockPool<block_size>& pool()
+            {
+                static thread_local BlockPool<block_size> pool;
+                return pool;
+            }
+
+        public:
+            FlatNodeRef(const FlatAst& ast, NodeIndex index)
+                : ast_{ast}
+                , index_{index}
+            {
+            }
+
+            void accept(AstVisitor& v) override;
+
+            // objects of derived classes do not fit blocks of the pool - they use the global heap
+            static void* operator new(size_t size)
+            {
+                static_assert(sizeof(FlatNodeRef) <= block_size);
+
+                if (size > block_size)
+                    return ::operator new(size);
+
+                return pool().allocate();
+            }
+
+            static void operator delete(void* ptr, size_t size) noexcept
+            {
+                if (size > block_size)
+                    ::operator delete(ptr);
+                else
+                    pool().deallocate(ptr);
+            }
+        };
+    }
+
+    // Expression tree stored in one contiguous array (an arena) - children are referred to
+    // by 32-bit indices. Children are always added before their parents, so nodes are kept
+    // in postfix order and the last added node is the root. All nodes are freed at once.
+    // A node may be a child of many parents - the arena then holds a DAG (see DagOptimizer).
+    class FlatAst
+    {
+    public:
+        enum class NodeKind : uint8_t
+        {
+            add,
+            multiply,
+            integer,
+            variable
+        };
+
+        struct Node
+        {
+            NodeKind kind;
+            union
+            {
+                int value; // integer
+                uint32_t variable; // variable
+                NodeIndex left; // add & multiply
+            };
+            NodeIndex right;
+        };
+
+        FlatAst() = default;
+
+        // copies a tree built with AST::helpers
+        static FlatAst from(ExpressionNode& expr);
+
+        void reserve(size_t node_count)
+        {
+            nodes_.reserve(node_count);
+        }
+
+        NodeIndex integer(int value)
+        {
+            Node node{NodeKind::integer, {}, 0};
+            node.value = value;
+            return push(node);
+        }
+
+        NodeIndex variable(uint32_t index)
+        {
+            Node node{NodeKind::variable, {}, 0};
+            node.variable = index;
+            return push(node);
+        }
+
+        NodeIndex add(NodeIndex left, NodeIndex right)
+        {
+            return push_binary(NodeKind::add, left, right);
+        }
+
+        NodeIndex multiply(NodeIndex left, NodeIndex right)
+        {
+            return push_binary(NodeKind::multiply, left, right);
+        }
+
+        size_t size() const
+        {
+            return nodes_.size();
+        }
+
+        bool empty() const
+        {
+            return nodes_.empty();
+        }
+
+        NodeIndex root() const
+        {
+            assert(!empty());
+            return static_cast<NodeIndex>(nodes_.size() - 1);
+        }
+
+        const Node& node(NodeIndex index) const
+        {
+            return nodes_[index];
+        }
+
+        // nodes hold no resources - only the arena is released
+        void clear()
+        {
+            nodes_.clear();
+        }
+
+        // walks the tree with a visitor written for AST nodes - each node is materialized
+        // on the stack for the duration of its visit
+        void accept(AstVisitor& v) const
+        {
+            accept(root(), v);
+        }
+
+        void accept(NodeIndex index, AstVisitor& v) const
+        {
+            const Node& n = nodes_[index];
+
+            switch (n.kind)
+            {
+            case NodeKind::add:
+            {
+                AddNode node{make_ref(n.left), make_ref(n.right)};
+                v.visit(node);
+                break;
+            }
+            case NodeKind::multiply:
+            {
+                MultiplyNode node{make_ref(n.left), make_ref(n.right)};
+                v.visit(node);
+                break;
+            }
+            case NodeKind::integer:
+            {
+                IntNode node{n.value};
+                v.visit(node);
+                break;
+            }
+            case NodeKind::variable:
+            {
+                VariableNode node{n.variable};
+                v.visit(node);
+                break;
+            }
+            }
+        }
+
+        // single pass over the arena - children are evaluated before their parents;
+        // variables - values of variables of the expression (indexed by variable index)
+        int evaluate(const std::vector<int>* variables = nullptr) const
+        {
+            std::vector<int> values(nodes_.size());
+
+            for (size_t i = 0; i < nodes_.size(); ++i)
+            {
+                const Node& n = nodes_[i];
+
+                switch (n.kind)
+                {
+                case NodeKind::add:
+                    values[i] = wrapping_add(values[n.left], values[n.right]);
+                    break;
+                case NodeKind::multiply:
+                    values[i] = wrapping_multiply(values[n.left], values[n.right]);
+                    break;
+                case NodeKind::integer:
+                    values[i] = n.value;
+                    break;
+                case NodeKind::variable:
+                    values[i] = variable_value(variables, n.variable);
+                    break;
+                }
+            }
+
+            return values.empty() ? 0 : values.back();
+        }
+
+    private:
+        std::vector<Node> nodes_;
+
+        NodeIndex push(const Node& node)
+        {
+            assert(nodes_.size() < UINT32_MAX);
+            nodes_.push_back(node);
+            return static_cast<NodeIndex>(nodes_.size() - 1);
+        }
+
+        NodeIndex push_binary(NodeKind kind, NodeIndex left, NodeIndex right)
+        {
+            assert(left < nodes_.size() && right < nodes_.size());
+
+            Node node{kind, {}, right};
+            node.left = left;
+            return push(node);
+        }
+
+        ExpressionNodePtr make_ref(NodeIndex index) const
+        {
+            return ExpressionNodePtr{new Details::FlatNodeRef{*this, index}};
+        }
+    };
+
+    inline void Details::FlatNodeRef::accept(AstVisitor& v)
+    {
+        ast_.accept(index_, v);
+    }
+
+    namespace Details
+    {
+        // copies nodes of a tree to an arena in postfix order
+        class FlatAstBuilder : public AstVisitor
+        {
+            FlatAst& ast_;
+            NodeIndex last_{};
+
+        public:
+            explicit FlatAstBuilder(FlatAst& ast)
+                : ast_{ast}
+            {
+            }
+
+            void visit(AddNode& node) override
+            {
+                node.left().accept(*this);
+                const NodeIndex left = last_;
+                node.right().accept(*this);
+                last_ = ast_.add(left, last_);
+            }
+
+            void visit(MultiplyNode& node) override
+            {
+                node.left().accept(*this);
+                const NodeIndex left = last_;
+                node.right().accept(*this);
+                last_ = ast_.multiply(left, last_);
+            }
+
+            void visit(IntNode& node) override
+            {
+                last_ = ast_.integer(node.value());
+            }
+
+            void visit(VariableNode& node) override
+            {
+                if (node.index() > UINT32_MAX)
+                    throw std::out_of_range("Variable index does not fit FlatAst");
+
+                last_ = ast_.variable(static_cast<uint32_t>(node.index()));
+            }
+        };
+    }
+
+    namespace Details
+    {
+        // adds nodes to an arena - the counterpart of TreeNodeFactory
+        struct FlatNodeFactory
+        {
+            using Node = NodeIndex;
+
+            FlatAst& ast;
+
+            Node integer(int value)
+            {
+                return ast.integer(value);
+            }
+
+            Node variable(uint32_t index)
+            {
+                return ast.variable(index);
+            }
+
+            Node add(Node left, Node right)
+            {
+                return ast.add(left, right);
+            }
+
+            Node multiply(Node left, Node right)
+            {
+                return ast.multiply(left, right);
+            }
+        };
+    }
+
+    inline FlatAst FlatAst::from(ExpressionNode& expr)
+    {
+        FlatAst ast;
+        Details::FlatAstBuilder builder{ast};
+        expr.accept(builder);
+
+        return ast;
+    }
+}
+
+#endif // FLAT_AST_HPP
@@ -0,0 +1,298 @@
+#ifndef PARALLEL_EVAL_HPP
+#define PARALLEL_EVAL_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "ast.hpp"
+#include "thread_pool.hpp"
+#include "visitors.hpp"
+
+// Evaluation of large trees on a work-stealing pool. A node whose both subtrees have at least
+// fork_threshold nodes is split - its left subtree is forked as a task, the right one is
+// evaluated by the current thread. Smaller subtrees are evaluated sequentially (stack-safe).
+// Sizes of subtrees are counted once, when the evaluator is created - the tree must not change
+// while the evaluator is used.
+class ParallelEvaluator
+{
+    // node of the plan - steps are stored children first, the root is the last one
+    struct Step
+    {
+        enum Kind
+        {
+            add,
+            multiply,
+            sequential // subtree evaluated by one thread
+        };
+
+        Kind kind;
+        AST::ExpressionNode* subtree; // sequential
+        size_t left; // add & multiply
+        size_t right;
+        size_t size; // nodes of the subtree
+    };
+
+    // counts sizes of subtrees and splits the ones worth forking - post-order with an explicit
+    // stack, so planning is not limited by the depth of the tree
+    class Planner
+    {
+        static constexpr size_t not_planned = SIZE_MAX;
+
+        struct Subtree
+        {
+            AST::ExpressionNode* node;
+            size_t size;
+            size_t step; // not_planned for subtrees without forks
+        };
+
+        // binary node with its left subtree planned or being planned
+        struct Frame
+        {
+            AST::ExpressionNode* node;
+            Step::Kind kind;
+            AST::ExpressionNode* right; // nullptr once the right subtree is being planned
+            Subtree left;
+        };
+
+        // classifies a node without descending into it
+        class NodeDecoder final : public AST::AstVisitor
+        {
+        public:
+            bool is_leaf{};
+            Step::Kind kind{};
+            AST::ExpressionNode* left{};
+            AST::ExpressionNode* right{};
+
+            void visit(AST::AddNode& node) override
+            {
+                set_binary(Step::add, node.left(), node.right());
+            }
+
+            void visit(AST::MultiplyNode& node) override
+            {
+                set_binary(Step::multiply, node.left(), node.right());
+            }
+
+            void visit(AST::IntNode&) override
+            {
+                is_leaf = true;
+            }
+
+            void visit(AST::VariableNode&) override
+            {
+                is_leaf = true;
+            }
+
+        private:
+            void set_binary(Step::Kind node_kind, AST::ExpressionNode& left_node, AST::ExpressionNode& right_node)
+            {
+                is_leaf = false;
+                kind = node_kind;
+                left = &left_node;
+                right = &right_node;
+            }
+        };
+
+        std::vector<Step>& plan_;
+        size_t fork_threshold_;
+
+    public:
+        Planner(std::vector<Step>& plan, size_t fork_threshold)
+            : plan_{plan}
+            , fork_threshold_{fork_threshold}
+        {
+        }
+
+        void plan(AST::ExpressionNode& root)
+        {
+            NodeDecoder decoder;
+            std::vector<Frame> frames;
+            AST::ExpressionNode* node = &root;
+
+            while (true)
+            {
+                // descends along left children - only right children wait on the stack
+                node->accept(decoder);
+                while (!decoder.is_leaf)
+                {
+                    frames.push_back(Frame{node, decoder.kind, decoder.right, {}});
+                    node = decoder.left;
+                    node->accept(decoder);
+                }
+
+                Subtree subtree{node, 1, not_planned};
+
+                // combines finished subtrees until a right subtree is left to plan
+                while (!frames.empty() && frames.back().right == nullptr)
+                {
+                    const Frame& frame = frames.back();
+                    subtree = combine(frame.node, frame.kind, frame.left, subtree);
+                    frames.pop_back();
+                }
+
+                if (frames.empty())
+                {
+                    to_step(subtree);
+                    return;
+                }
+
+                Frame& frame = frames.back();
+                frame.left = subtree;
+                node = std::exchange(frame.right, nullptr);
+            }
+        }
+
+    private:
+        Subtree combine(AST::ExpressionNode* node, Step::Kind kind, const Subtree& left, const Subtree& right)
+        {
+            const size_t size = 1 + left.size + right.size;
+            const bool worth_forking = left.size >= fork_threshold_ && right.size >= fork_threshold_;
+
+            // a node above a split one is split too - forks below it stay reachable
+            if (worth_forking || left.step != not_planned || right.step != not_planned)
+            {
+                const size_t left_step = to_step(left);
+                const size_t right_step = to_step(right);
+                plan_.push_back(Step{kind, nullptr, left_step, right_step, size});
+                return Subtree{node, size, plan_.size() - 1};
+            }
+
+            return Subtree{node, size, not_planned};
+        }
+
+        size_t to_step(const Subtree& subtree)
+        {
+            if (subtree.step != not_planned)
+                return subtree.step;
+
+            plan_.push_back(Step{Step::sequential, subtree.node, 0, 0, subtree.size});
+            return plan_.size() - 1;
+        }
+    };
+
+    WorkStealingPool& pool_;
+    size_t fork_threshold_;
+    std::vector<Step> plan_;
+
+    // how long a thread waits for a forked task before looking for queued tasks again
+    static constexpr std::chrono::seconds join_wait{1};
+
+public:
+    static constexpr size_t default_fork_threshold = 1 << 14;
+
+    ParallelEvaluator(WorkStealingPool& pool, AST::ExpressionNode& expr, size_t fork_threshold = default_fork_threshold)
+        : pool_{pool}
+        , fork_threshold_{fork_threshold}
+    {
+        Planner{plan_, fork_threshold_}.plan(expr);
+    }
+
+    ParallelEvaluator(const ParallelEvaluator&) = delete;
+    ParallelEvaluator& operator=(const ParallelEvaluator&) = delete;
+
+    // variables - values of variables of the expression (indexed by VariableNode::index())
+    int evaluate(const std::vector<int>* variables = nullptr) const
+    {
+        return run(plan_.size() - 1, variables);
+    }
+
+    // number of subtrees evaluated sequentially - the units of work shared by threads
+    size_t sequential_task_count() const
+    {
+        size_t count = 0;
+        for (const Step& step : plan_)
+            count += (step.kind == Step::sequential);
+
+        return count;
+    }
+
+private:
+    int run(size_t index, const std::vector<int>* variables) const
+    {
+        const Step& step = plan_[index];
+
+        if (step.kind == Step::sequential)
+        {
+            IterativeEvalVisitor visitor{variables};
+            step.subtree->accept(visitor);
+            return visitor.result();
+        }
+
+        int left = 0;
+        int right = 0;
+
+        if (plan_[step.left].size >= fork_threshold_ && plan_[step.right].size >= fork_threshold_)
+        {
+            struct Fork
+            {
+                std::mutex mtx;
+                std::condition_variable finished;
+                bool done{};
+                int value{};
+                std::exception_ptr error;
+            } fork;
+
+            pool_.submit([this, &fork, &step, variables] {
+                try
+                {
+                    fork.value = run(step.left, variables);
+                }
+                catch (...)
+                {
+                    fork.error = std::current_exception();
+                }
+
+                // notified under the lock - the joining thread cannot destroy fork before it is notified
+                std::lock_guard<std::mutex> lk{fork.mtx};
+                fork.done = true;
+                fork.finished.notify_one();
+            });
+
+            std::exception_ptr right_error;
+            try
+            {
+                right = run(step.right, variables);
+            }
+            catch (...)
+            {
+                right_error = std::current_exception();
+            }
+
+            // the forked task refers to this frame - it has to finish even if the right subtree failed;
+            // queued tasks are run while there are any, then the thread sleeps until the fork is done
+            std::unique_lock<std::mutex> lk{fork.mtx};
+            while (!fork.done)
+            {
+                lk.unlock();
+                const bool helped = pool_.run_pending_task();
+                lk.lock();
+
+                if (!helped)
+                    fork.finished.wait_for(lk, join_wait, [&fork] { return fork.done; });
+            }
+            lk.unlock();
+
+            if (right_error)
+                std::rethrow_exception(right_error);
+            if (fork.error)
+                std::rethrow_exception(fork.error);
+
+            left = fork.value;
+        }
+        else
+        {
+            left = run(step.left, variables);
+            right = run(step.right, variables);
+        }
+
+        return step.kind == Step::add ? AST::wrapping_add(left, right) : AST::wrapping_multiply(left, right);
+    }
+};
+
+#endif // PARALLEL_EVAL_HPP
@@ -0,0 +1,270 @@
+#ifndef PARSER_HPP
+#define PARSER_HPP
+
+#include <cassert>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "ast.hpp"
+#include "flat_ast.hpp"
+
+namespace AST
+{
+    class ParseError : public std::runtime_error
+    {
+        size_t offset_;
+
+    public:
+        ParseError(const std::string& message, size_t offset)
+            : std::runtime_error{message + " at offset " + std::to_string(offset)}
+            , offset_{offset}
+        {
+        }
+
+        // position of the error in the parsed text
+        size_t offset() const
+        {
+            return offset_;
+        }
+    };
+
+    struct Token
+    {
+        enum Kind
+        {
+            integer, // digits optionally preceded by '-', e.g. -12
+            variable, // x followed by the index of a variable, e.g. x0
+            plus,
+            star,
+            left_paren,
+            right_paren,
+            end
+        };
+
+        Kind kind;
+        std::string_view text;
+        size_t offset;
+    };
+
+    // Splits text into tokens - they refer to the text, nothing is copied
+    class Lexer
+    {
+        std::string_view text_;
+        size_t pos_{};
+
+    public:
+        explicit Lexer(std::string_view text) : text_{text}
+        {
+        }
+
+        Token next()
+        {
+            while (pos_ < text_.size() && is_space(text_[pos_]))
+                ++pos_;
+
+            const size_t start = pos_;
+            if (pos_ == text_.size())
+                return Token{Token::end, {}, start};
+
+            const char c = text_[pos_++];
+            switch (c)
+            {
+            case '+':
+                return Token{Token::plus, text_.substr(start, 1), start};
+            case '*':
+                return Token{Token::star, text_.substr(start, 1), start};
+            case '(':
+                return Token{Token::left_paren, text_.substr(start, 1), start};
+            case ')':
+                return Token{Token::right_paren, text_.substr(start, 1), start};
+            case '-':
+                // a sign of an integer - there is no subtraction
+                if (pos_ == text_.size() || !is_digit(text_[pos_]))
+                    throw ParseError("Expected digits of a negative integer", start);
+                skip_digits();
+                return Token{Token::integer, text_.substr(start, pos_ - start), start};
+            case 'x':
+                skip_digits();
+                if (pos_ == start + 1)
+                    throw ParseError("Expected an index of a variable", pos_);
+                return Token{Token::variable, text_.substr(start, pos_ - start), start};
+            default:
+                if (!is_digit(c))
+                    throw ParseError(std::string{"Unexpected character '"} + c + "'", start);
+                skip_digits();
+                return Token{Token::integer, text_.substr(start, pos_ - start), start};
+            }
+        }
+
+    private:
+        static bool is_space(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+        }
+
+        static bool is_digit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        void skip_digits()
+        {
+            while (pos_ < text_.size() && is_digit(text_[pos_]))
+                ++pos_;
+        }
+    };
+
+    // Parser of infix expressions with +, *, parentheses, integers (also negative, e.g. -5) and variables (x0, x1, ...).
+    // Single pass without recursion (shunting-yard) - nesting depth is limited only by memory.
+    // Stacks of operands and operators are kept between calls, so parsing allocates nothing
+    // except nodes of a tree (or the growth of an arena).
+    class Parser
+    {
+        enum class Operator : uint8_t
+        {
+            add,
+            multiply,
+            paren
+        };
+
+        struct PendingOperator
+        {
+            Operator op;
+            size_t offset;
+        };
+
+        std::vector<PendingOperator> operators_;
+        std::vector<ExpressionNodePtr> tree_operands_;
+        std::vector<NodeIndex> flat_operands_;
+
+    public:
+        ExpressionNodePtr parse(std::string_view text)
+        {
+            Details::TreeNodeFactory builder;
+            return parse(text, builder, tree_operands_);
+        }
+
+        // appends nodes of the expression to ast - returns the index of its root
+        NodeIndex parse(std::string_view text, FlatAst& ast)
+        {
+            Details::FlatNodeFactory builder{ast};
+            return parse(text, builder, flat_operands_);
+        }
+
+    private:
+        template <typename Builder>
+        typename Builder::Node parse(std::string_view text, Builder& builder, std::vector<typename Builder::Node>& operands)
+        {
+            operators_.clear();
+            operands.clear();
+
+            Lexer lexer{text};
+            bool expect_operand = true;
+
+            while (true)
+            {
+                const Token token = lexer.next();
+
+                if (expect_operand)
+                {
+                    switch (token.kind)
+                    {
+                    case Token::integer:
+                        operands.push_back(builder.integer(parse_number<int>(token.text, token.offset)));
+                        expect_operand = false;
+                        break;
+                    case Token::variable:
+                        operands.push_back(builder.variable(parse_number<uint32_t>(token.text.substr(1), token.offset + 1)));
+                        expect_operand = false;
+                        break;
+                    case Token::left_paren:
+                        operators_.push_back(PendingOperator{Operator::paren, token.offset});
+                        break;
+                    default:
+                        throw ParseError("Expected an integer, a variable or '('", token.offset);
+                    }
+
+                    continue;
+                }
+
+                switch (token.kind)
+                {
+                case Token::plus:
+                    push_operator(PendingOperator{Operator::add, token.offset}, builder, operands);
+                    expect_operand = true;
+                    break;
+                case Token::star:
+                    push_operator(PendingOperator{Operator::multiply, token.offset}, builder, operands);
+                    expect_operand = true;
+                    break;
+                case Token::right_paren:
+                    reduce_while(builder, operands, [](Operator op) { return op != Operator::paren; });
+                    if (operators_.empty())
+                        throw ParseError("Unmatched ')'", token.offset);
+                    operators_.pop_back();
+                    break;
+                case Token::end:
+                    reduce_while(builder, operands, [](Operator op) { return op != Operator::paren; });
+                    if (!operators_.empty())
+                        throw ParseError("Unmatched '('", operators_.back().offset);
+                    assert(operands.size() == 1);
+                    return std::move(operands.back());
+                default:
+                    throw ParseError("Expected '+', '*' or ')'", token.offset);
+                }
+            }
+        }
+
+        static int precedence(Operator op)
+        {
+            return op == Operator::multiply ? 2 : (op == Operator::add ? 1 : 0);
+        }
+
+        // operators are left-associative - pending ones of the same or higher precedence are applied first
+        template <typename Builder>
+        void push_operator(PendingOperator pending, Builder& builder, std::vector<typename Builder::Node>& operands)
+        {
+            const int op_precedence = precedence(pending.op);
+            reduce_while(builder, operands, [op_precedence](Operator op) { return precedence(op) >= op_precedence; });
+            operators_.push_back(pending);
+        }
+
+        template <typename Builder, typename Predicate>
+        void reduce_while(Builder& builder, std::vector<typename Builder::Node>& operands, Predicate predicate)
+        {
+            while (!operators_.empty() && predicate(operators_.back().op))
+            {
+                const Operator op = operators_.back().op;
+                operators_.pop_back();
+
+                auto right = std::move(operands.back());
+                operands.pop_back();
+                auto left = std::move(operands.back());
+                operands.pop_back();
+
+                operands.push_back(op == Operator::add ? builder.add(std::move(left), std::move(right)) : builder.multiply(std::move(left), std::move(right)));
+            }
+        }
+
+        template <typename Number>
+        static Number parse_number(std::string_view digits, size_t offset)
+        {
+            Number value{};
+            const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value);
+
+            if (error == std::errc::result_out_of_range)
+                throw ParseError("Number out of range", offset);
+
+            assert(error == std::errc{} && end == digits.data() + digits.size());
+            return value;
+        }
+    };
+}
+
+#endif // PARSER_HPP
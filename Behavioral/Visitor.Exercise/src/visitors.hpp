@@ -3,25 +3,40 @@
 
 #include "ast.hpp"
 
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
 class ExprEvalVisitor : public AST::AstVisitor
 {
+    const std::vector<int>* variables_;
     int result_{};
 
 public:
+    // variables - values of variables of the expression (indexed by VariableNode::index())
+    explicit ExprEvalVisitor(const std::vector<int>* variables = nullptr) : variables_{variables}
+    {
+    }
+
     void visit(AST::AddNode& node)
     {
-        ExprEvalVisitor lv, rv;
+        ExprEvalVisitor lv{variables_}, rv{variables_};
         node.left().accept(lv);
         node.right().accept(rv);
-        result_ = lv.result() + rv.result();
+        result_ = AST::wrapping_add(lv.result(), rv.result());
     }
 
     void visit(AST::MultiplyNode& node)
     {
-        ExprEvalVisitor lv, rv;
+        ExprEvalVisitor lv{variables_}, rv{variables_};
         node.left().accept(lv);
         node.right().accept(rv);
-        result_ = lv.result() * rv.result();
+        result_ = AST::wrapping_multiply(lv.result(), rv.result());
     }
 
     void visit(AST::IntNode& node)
@@ -29,15 +44,394 @@ public:
         result_ = node.value();
     }
 
+    void visit(AST::VariableNode& node)
+    {
+        result_ = AST::variable_value(variables_, node.index());
+    }
+
+    int result() const
+    {
+        return result_;
+    }
+};
+
+// Evaluation in bounded native stack for any depth of a tree. The top levels of a tree
+// are evaluated recursively (with one visitor object), subtrees below max_recursion_depth
+// post-order with an explicit stack - kept between evaluations.
+class IterativeEvalVisitor : public AST::AstVisitor
+{
+    enum class Kind
+    {
+        add,
+        multiply,
+        leaf // integer or variable - its value is known
+    };
+
+    // binary node with its left subtree evaluated or being evaluated
+    struct Frame
+    {
+        Kind kind;
+        AST::ExpressionNode* right; // nullptr once the right subtree is being evaluated
+        int left_value;
+    };
+
+    // classifies a node without descending into it
+    class NodeDecoder final : public AST::AstVisitor
+    {
+        const std::vector<int>* variables_;
+
+    public:
+        Kind kind{};
+        AST::ExpressionNode* left{};
+        AST::ExpressionNode* right{};
+        int value{};
+
+        explicit NodeDecoder(const std::vector<int>* variables) : variables_{variables}
+        {
+        }
+
+        void visit(AST::AddNode& node) override
+        {
+            kind = Kind::add;
+            left = &node.left();
+            right = &node.right();
+        }
+
+        void visit(AST::MultiplyNode& node) override
+        {
+            kind = Kind::multiply;
+            left = &node.left();
+            right = &node.right();
+        }
+
+        void visit(AST::IntNode& node) override
+        {
+            kind = Kind::leaf;
+            value = node.value();
+        }
+
+        void visit(AST::VariableNode& node) override
+        {
+            kind = Kind::leaf;
+            value = AST::variable_value(variables_, node.index());
+        }
+    };
+
+    const std::vector<int>* variables_;
+    std::vector<Frame> frames_;
+    size_t depth_{};
+    int result_{};
+
+public:
+    static constexpr size_t max_recursion_depth = 256;
+
+    explicit IterativeEvalVisitor(const std::vector<int>* variables = nullptr) : variables_{variables}
+    {
+    }
+
+    void visit(AST::AddNode& node) override
+    {
+        if (depth_ == max_recursion_depth)
+        {
+            evaluate(node);
+            return;
+        }
+
+        ++depth_;
+        node.left().accept(*this);
+        const int left = result_;
+        node.right().accept(*this);
+        result_ = AST::wrapping_add(left, result_);
+        --depth_;
+    }
+
+    void visit(AST::MultiplyNode& node) override
+    {
+        if (depth_ == max_recursion_depth)
+        {
+            evaluate(node);
+            return;
+        }
+
+        ++depth_;
+        node.left().accept(*this);
+        const int left = result_;
+        node.right().accept(*this);
+        result_ = AST::wrapping_multiply(left, result_);
+        --depth_;
+    }
+
+    void visit(AST::IntNode& node) override
+    {
+        result_ = node.value();
+    }
+
+    void visit(AST::VariableNode& node) override
+    {
+        result_ = AST::variable_value(variables_, node.index());
+    }
+
     int result() const
     {
         return result_;
     }
+
+private:
+    void evaluate(AST::ExpressionNode& root)
+    {
+        NodeDecoder decoder{variables_};
+        AST::ExpressionNode* node = &root;
+        frames_.clear();
+
+        while (true)
+        {
+            // descends along left children - only right children wait on the stack
+            node->accept(decoder);
+            while (decoder.kind != Kind::leaf)
+            {
+                frames_.push_back(Frame{decoder.kind, decoder.right, 0});
+                decoder.left->accept(decoder);
+            }
+
+            int value = decoder.value;
+
+            // combines values of finished subtrees until a right subtree is left to evaluate
+            while (!frames_.empty() && frames_.back().right == nullptr)
+            {
+                const Frame& frame = frames_.back();
+                value = (frame.kind == Kind::add) ? AST::wrapping_add(frame.left_value, value) : AST::wrapping_multiply(frame.left_value, value);
+                frames_.pop_back();
+            }
+
+            if (frames_.empty())
+            {
+                result_ = value;
+                return;
+            }
+
+            Frame& frame = frames_.back();
+            frame.left_value = value;
+            node = std::exchange(frame.right, nullptr);
+        }
+    }
 };
 
-// TODO
-class PrintingVisitor
+// Prints an expression in infix notation to a buffer - its capacity is reused by subsequent prints,
+// so printing does not allocate per node. With an output stream the buffer is written to it in
+// chunks - a tree of any size is printed in bounded memory. Like IterativeEvalVisitor it switches
+// from recursion to an explicit stack in deep trees.
+class PrintingVisitor : public AST::AstVisitor
 {
+public:
+    enum class Parentheses
+    {
+        full, // around every operation, e.g. (3 + (2 * 5))
+        minimal // only where needed, negative integers with a sign (1 + -2) - AST::Parser builds the same tree from the text
+    };
+
+    static constexpr size_t max_recursion_depth = 256;
+    static constexpr size_t default_chunk_size = 64 * 1024;
+
+    // out - stream the text is written to whenever the buffer reaches chunk_size (nullptr - text is kept in str())
+    explicit PrintingVisitor(Parentheses parentheses = Parentheses::full, std::ostream* out = nullptr, size_t chunk_size = default_chunk_size)
+        : parentheses_{parentheses}
+        , out_{out}
+        , chunk_size_{chunk_size}
+    {
+        if (out_)
+            buffer_.reserve(chunk_size_ + max_token_size);
+    }
+
+    PrintingVisitor(const PrintingVisitor&) = delete;
+    PrintingVisitor& operator=(const PrintingVisitor&) = delete;
+
+    ~PrintingVisitor() override
+    {
+        if (out_)
+            flush();
+    }
+
+    void visit(AST::AddNode& node) override
+    {
+        print_binary(node, Precedence::sum);
+    }
+
+    void visit(AST::MultiplyNode& node) override
+    {
+        print_binary(node, Precedence::product);
+    }
+
+    void visit(AST::IntNode& node) override
+    {
+        print_number(node.value());
+    }
+
+    void visit(AST::VariableNode& node) override
+    {
+        put('x');
+        print_number(node.index());
+    }
+
+    // text printed since the last clear() or flush()
+    const std::string& str() const
+    {
+        return buffer_;
+    }
+
+    // empties the buffer - its capacity is kept
+    void clear()
+    {
+        buffer_.clear();
+    }
+
+    // writes the buffer to the stream
+    void flush()
+    {
+        if (out_ && !buffer_.empty())
+        {
+            out_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+    }
+
+private:
+    enum class Precedence : uint8_t
+    {
+        none, // top level
+        sum,
+        product
+    };
+
+    // binary node with its left subtree printed or being printed
+    struct Frame
+    {
+        AST::ExpressionNode* right; // nullptr once the right subtree is being printed
+        Precedence precedence;
+        bool parenthesized;
+    };
+
+    static constexpr size_t max_token_size = 24; // the longest number or operator
+
+    Parentheses parentheses_;
+    std::ostream* out_;
+    size_t chunk_size_;
+    std::string buffer_;
+    std::vector<Frame> frames_;
+    size_t depth_{};
+    bool iterative_{};
+    AST::ExpressionNode* next_{}; // left child to print next - iterative mode
+    Precedence enclosing_{Precedence::none};
+    bool right_operand_{};
+
+    template <typename Node>
+    void print_binary(Node& node, Precedence precedence)
+    {
+        if (!iterative_ && depth_ == max_recursion_depth)
+        {
+            print_iteratively(node);
+            return;
+        }
+
+        // operators are left-associative - a right operand of the same precedence keeps its parentheses
+        const bool parenthesized = parentheses_ == Parentheses::full || precedence < enclosing_
+            || (precedence == enclosing_ && right_operand_);
+
+        if (parenthesized)
+            put('(');
+
+        if (iterative_)
+        {
+            frames_.push_back(Frame{&node.right(), precedence, parenthesized});
+            next_ = &node.left();
+            enclosing_ = precedence;
+            right_operand_ = false;
+            return;
+        }
+
+        const Precedence enclosing = std::exchange(enclosing_, precedence);
+        const bool right_operand = right_operand_;
+
+        ++depth_;
+        right_operand_ = false;
+        node.left().accept(*this);
+        write(operator_text(precedence));
+        right_operand_ = true;
+        node.right().accept(*this);
+        --depth_;
+
+        if (parenthesized)
+            put(')');
+
+        enclosing_ = enclosing;
+        right_operand_ = right_operand;
+    }
+
+    void print_iteratively(AST::ExpressionNode& root)
+    {
+        const Precedence enclosing = enclosing_;
+        const bool right_operand = right_operand_;
+        AST::ExpressionNode* node = &root;
+        frames_.clear();
+        iterative_ = true;
+
+        while (true)
+        {
+            // descends along left children - only right children wait on the stack
+            do
+            {
+                next_ = nullptr;
+                node->accept(*this);
+                node = next_;
+            } while (node);
+
+            // closes subtrees until a right subtree is left to print
+            while (!frames_.empty() && frames_.back().right == nullptr)
+            {
+                if (frames_.back().parenthesized)
+                    put(')');
+                frames_.pop_back();
+            }
+
+            if (frames_.empty())
+                break;
+
+            Frame& frame = frames_.back();
+            write(operator_text(frame.precedence));
+            enclosing_ = frame.precedence;
+            right_operand_ = true;
+            node = std::exchange(frame.right, nullptr);
+        }
+
+        iterative_ = false;
+        enclosing_ = enclosing;
+        right_operand_ = right_operand;
+    }
+
+    static std::string_view operator_text(Precedence precedence)
+    {
+        return precedence == Precedence::sum ? " + " : " * ";
+    }
+
+    template <typename Number>
+    void print_number(Number value)
+    {
+        char digits[max_token_size];
+        const auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+        write(std::string_view{digits, static_cast<size_t>(result.ptr - digits)});
+    }
+
+    void put(char c)
+    {
+        write(std::string_view{&c, 1});
+    }
+
+    void write(std::string_view text)
+    {
+        buffer_.append(text);
+
+        if (out_ && buffer_.size() >= chunk_size_)
+            flush();
+    }
 };
 
 #endif // VISITORS_HPP
\ No newline at end of file
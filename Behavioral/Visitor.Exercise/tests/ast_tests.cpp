@@ -45,40 +45,38 @@ TEST_CASE("expression evaluator visitor", "[ast]")
 
 TEST_CASE("printing visitor")
 {
-    // TODO - uncomment tests
+    PrintingVisitor visitor;
 
-    // PrintingVisitor visitor;
-
-    // SECTION("integer")
-    // {
-    //     auto expr = integer(4);
-    //     expr->accept(visitor);
+    SECTION("integer")
+    {
+        auto expr = integer(4);
+        expr->accept(visitor);
 
-    //     REQUIRE(visitor.str() == "4");
-    // }
+        REQUIRE(visitor.str() == "4");
+    }
 
-    // SECTION("addition")
-    // {
-    //     auto expr = add(integer(1), integer(2));
-    //     expr->accept(visitor);
+    SECTION("addition")
+    {
+        auto expr = add(integer(1), integer(2));
+        expr->accept(visitor);
 
-    //     REQUIRE(visitor.str() == "(1 + 2)");
-    // }
+        REQUIRE(visitor.str() == "(1 + 2)");
+    }
 
-    // SECTION("multiplication")
-    // {
-    //     auto expr = multiply(integer(2), integer(3));
-    //     expr->accept(visitor);
+    SECTION("multiplication")
+    {
+        auto expr = multiply(integer(2), integer(3));
+        expr->accept(visitor);
 
-    //     REQUIRE(visitor.str() == "(2 * 3)");
-    // }
+        REQUIRE(visitor.str() == "(2 * 3)");
+    }
 
-    // SECTION("composite expression")
-    // {
-    //     auto expr = add(integer(3), multiply(integer(2), integer(5)));
+    SECTION("composite expression")
+    {
+        auto expr = add(integer(3), multiply(integer(2), integer(5)));
 
-    //     expr->accept(visitor);
+        expr->accept(visitor);
 
-    //     REQUIRE(visitor.str() == "(3 + (2 * 5))");
-    // }
+        REQUIRE(visitor.str() == "(3 + (2 * 5))");
+    }
 }
@@ -0,0 +1,127 @@
+#include "ast.hpp"
+#include "batch_eval.hpp"
+#include "bytecode.hpp"
+#include "flat_ast.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace AST;
+using namespace AST::helpers;
+
+namespace
+{
+    // (x0 + 3) * x1 + x0 * 2
+    ExpressionNodePtr make_formula()
+    {
+        return add(multiply(add(variable(0), integer(3)), variable(1)), multiply(variable(0), integer(2)));
+    }
+}
+
+TEST_CASE("variables", "[ast][variables]")
+{
+    auto expr = make_formula();
+    const std::vector<int> row = {4, 5};
+
+    SECTION("expression evaluator visitor")
+    {
+        ExprEvalVisitor visitor{&row};
+        expr->accept(visitor);
+
+        REQUIRE(visitor.result() == 43);
+    }
+
+    SECTION("iterative evaluator")
+    {
+        IterativeEvalVisitor visitor{&row};
+        expr->accept(visitor);
+
+        REQUIRE(visitor.result() == 43);
+    }
+
+    SECTION("bytecode")
+    {
+        auto program = BytecodeCompiler::compile(*expr);
+
+        REQUIRE(program.variable_count() == 2);
+        REQUIRE(program.run(&row) == 43);
+    }
+
+    SECTION("flat ast")
+    {
+        REQUIRE(FlatAst::from(*expr).evaluate(&row) == 43);
+    }
+
+    SECTION("missing value of a variable throws")
+    {
+        const std::vector<int> short_row = {4};
+        ExprEvalVisitor visitor{&short_row};
+
+        REQUIRE_THROWS_AS(expr->accept(visitor), std::out_of_range);
+        REQUIRE_THROWS_AS(BytecodeCompiler::compile(*expr).run(), std::out_of_range);
+    }
+}
+
+TEST_CASE("batch evaluator", "[batch_eval]")
+{
+    auto expr = make_formula();
+    BatchEvaluator evaluator{*expr};
+
+    SECTION("gives the same results as the visitor evaluated per row")
+    {
+        const size_t row_count = 3 * BatchEvaluator::chunk_size + 17; // the last chunk is partial
+        std::vector<int> x0(row_count), x1(row_count);
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            x0[i] = static_cast<int>(i % 100) - 50;
+            x1[i] = static_cast<int>(i % 7);
+        }
+
+        std::vector<int> output(row_count);
+        evaluator.evaluate({x0.data(), x1.data()}, row_count, output.data());
+
+        for (size_t i = 0; i < row_count; ++i)
+        {
+            const std::vector<int> row = {x0[i], x1[i]};
+            ExprEvalVisitor visitor{&row};
+            expr->accept(visitor);
+
+            REQUIRE(output[i] == visitor.result());
+        }
+    }
+
+    SECTION("expression without variables")
+    {
+        auto constant = add(integer(1), integer(2));
+        BatchEvaluator constant_evaluator{*constant};
+
+        std::vector<int> output(5);
+        constant_evaluator.evaluate({}, output.size(), output.data());
+
+        REQUIRE(output == std::vector<int>(5, 3));
+    }
+
+    SECTION("stack of a right-leaning chain stays shallow")
+    {
+        ExpressionNodePtr chain = variable(0);
+        for (int i = 0; i < 10'000; ++i)
+            chain = add(variable(0), std::move(chain));
+
+        BatchEvaluator chain_evaluator{*chain};
+        REQUIRE(chain_evaluator.program().max_stack_depth() == 2);
+
+        std::vector<int> x0 = {1, 2, 3}, output(3);
+        chain_evaluator.evaluate({x0.data()}, x0.size(), output.data());
+
+        REQUIRE(output == std::vector<int>{10'001, 20'002, 30'003});
+    }
+
+    SECTION("missing column throws")
+    {
+        std::vector<int> x0(10), output(10);
+
+        REQUIRE_THROWS_AS(evaluator.evaluate({x0.data()}, x0.size(), output.data()), std::out_of_range);
+    }
+}
@@ -0,0 +1,144 @@
+#include "ast.hpp"
+#include "binary_ast.hpp"
+#include "flat_ast.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <climits>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace AST;
+using namespace AST::helpers;
+
+namespace
+{
+    int evaluate(ExpressionNode& expr, const std::vector<int>* variables = nullptr)
+    {
+        ExprEvalVisitor visitor{variables};
+        expr.accept(visitor);
+        return visitor.result();
+    }
+
+    std::vector<SerializedExpression> expressions_of(const BinaryAstView& view)
+    {
+        std::vector<SerializedExpression> expressions;
+        view.for_each([&](const SerializedExpression& expr) { expressions.push_back(expr); });
+        return expressions;
+    }
+}
+
+TEST_CASE("binary ast", "[binary_ast]")
+{
+    BinaryAstWriter writer;
+    auto first = add(integer(3), multiply(integer(-2), integer(5)));
+    auto second = multiply(add(variable(0), integer(300)), variable(1));
+    writer.write(*first);
+    writer.write(*second);
+
+    const BinaryAstView view{writer.data()};
+    const auto expressions = expressions_of(view);
+    const std::vector<int> row = {1, 2};
+    std::vector<int> stack;
+
+    SECTION("records are postfix - small values are inlined, large ones follow as varints")
+    {
+        // integer 3, integer -2, integer 5, multiply, add
+        REQUIRE(expressions[0].records() == std::string{"\x18\x0C\x28\x03\x02", 5});
+        // variable 0, integer 300 (zigzag 600 - two bytes of varint), add, variable 1, multiply
+        REQUIRE(expressions[1].records().size() == 7);
+    }
+
+    SECTION("evaluated in place")
+    {
+        REQUIRE(expressions.size() == 2);
+        REQUIRE(expressions[0].evaluate(stack) == evaluate(*first));
+        REQUIRE(expressions[1].evaluate(stack, &row) == evaluate(*second, &row));
+    }
+
+    SECTION("nodes are rebuilt on demand")
+    {
+        auto tree = expressions[1].build();
+        REQUIRE(evaluate(*tree, &row) == 602);
+
+        FlatAst ast;
+        const auto root = expressions[0].build(ast);
+        REQUIRE(root == ast.root());
+        REQUIRE(ast.evaluate() == -7);
+    }
+
+    SECTION("mapped file")
+    {
+        const std::string file_path = (std::filesystem::temp_directory_path() / "visitor_binary_ast.bin").string();
+        writer.save(file_path);
+
+        {
+            MappedAstFile file{file_path};
+            const auto mapped = expressions_of(file.expressions());
+
+            REQUIRE(file.expressions().data() == writer.data());
+            REQUIRE(mapped.size() == 2);
+            REQUIRE(mapped[1].evaluate(stack, &row) == 602);
+        }
+
+        std::remove(file_path.c_str());
+    }
+
+    SECTION("values using all 32 bits fill a varint of 5 bytes")
+    {
+        BinaryAstWriter wide_writer;
+        wide_writer.write(*integer(INT_MIN)); // zigzag 0xFFFFFFFF
+
+        const auto wide = expressions_of(BinaryAstView{wide_writer.data()});
+        REQUIRE(wide[0].records() == std::string{"\xFC\xFF\xFF\xFF\xFF\x0F", 6});
+        REQUIRE(wide[0].evaluate(stack) == INT_MIN);
+    }
+}
+
+TEST_CASE("corrupted binary ast is reported", "[binary_ast]")
+{
+    BinaryAstWriter writer;
+    auto expr = add(integer(1), integer(2));
+    writer.write(*expr);
+    std::vector<int> stack;
+
+    SECTION("header")
+    {
+        REQUIRE_THROWS_AS(BinaryAstView{"not an ast"}, std::runtime_error);
+    }
+
+    SECTION("truncated expression")
+    {
+        const std::string data = writer.data().substr(0, writer.data().size() - 1);
+        const BinaryAstView view{data};
+
+        REQUIRE_THROWS_AS(expressions_of(view), std::runtime_error);
+    }
+
+    SECTION("records not forming one tree")
+    {
+        // expression of 2 bytes: add without operands
+        const std::string data = std::string{binary_ast_magic} + std::string{"\x02\x02\x02", 3};
+        const BinaryAstView view{data};
+
+        REQUIRE_THROWS_AS(expressions_of(view)[0].evaluate(stack), std::runtime_error);
+    }
+
+    SECTION("varint longer than 32 bits")
+    {
+        // size 3 with a 5th byte of varint carrying bits above 32
+        const std::string records = writer.data().substr(binary_ast_magic.size() + 1);
+        const std::string data = std::string{binary_ast_magic} + std::string{"\x83\x80\x80\x80\x10", 5} + records;
+        const BinaryAstView view{data};
+
+        REQUIRE_THROWS_AS(expressions_of(view), std::runtime_error);
+    }
+
+    SECTION("missing file")
+    {
+        REQUIRE_THROWS_AS(MappedAstFile{"/nonexistent/expressions.bin"}, std::runtime_error);
+    }
+}
@@ -0,0 +1,103 @@
+#include "ast.hpp"
+#include "bytecode.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <type_traits>
+#include <vector>
+
+using namespace AST;
+using namespace AST::helpers;
+
+TEST_CASE("bytecode compiler", "[bytecode]")
+{
+    SECTION("integer")
+    {
+        auto expr = integer(4);
+        auto program = BytecodeCompiler::compile(*expr);
+
+        REQUIRE(program.code() == std::vector<OpCode>{OpCode::push});
+        REQUIRE(program.run() == 4);
+    }
+
+    SECTION("code is postfix")
+    {
+        auto expr = add(multiply(integer(2), integer(5)), integer(3));
+        auto program = BytecodeCompiler::compile(*expr);
+
+        REQUIRE(program.code() == std::vector<OpCode>{OpCode::push, OpCode::push, OpCode::multiply, OpCode::push, OpCode::add});
+        REQUIRE(program.constants() == std::vector<int>{2, 5, 3});
+        REQUIRE(program.max_stack_depth() == 2);
+    }
+
+    SECTION("operand needing a deeper stack is emitted first")
+    {
+        auto expr = add(integer(3), multiply(integer(2), integer(5)));
+        auto program = BytecodeCompiler::compile(*expr);
+
+        REQUIRE(program.code() == std::vector<OpCode>{OpCode::push, OpCode::push, OpCode::multiply, OpCode::push, OpCode::add});
+        REQUIRE(program.constants() == std::vector<int>{2, 5, 3});
+        REQUIRE(program.max_stack_depth() == 2);
+        REQUIRE(program.run() == 13);
+    }
+
+    SECTION("left-leaning tree needs a shallow stack")
+    {
+        auto expr = add(multiply(add(integer(1), integer(2)), integer(3)), integer(4));
+        auto program = BytecodeCompiler::compile(*expr);
+
+        REQUIRE(program.max_stack_depth() == 2);
+        REQUIRE(program.run() == 13);
+    }
+
+    SECTION("right-leaning tree needs a shallow stack")
+    {
+        ExpressionNodePtr expr = integer(0);
+        for (int i = 1; i <= 1000; ++i)
+            expr = add(integer(i), std::move(expr));
+
+        auto program = BytecodeCompiler::compile(*expr);
+
+        REQUIRE(program.max_stack_depth() == 2);
+        REQUIRE(program.run() == 500500);
+    }
+
+    SECTION("stack of a balanced tree grows with its height")
+    {
+        ExpressionNodePtr balanced = add(multiply(add(integer(1), integer(2)), add(integer(3), integer(4))),
+            multiply(add(integer(5), integer(6)), add(integer(7), integer(8))));
+        auto program = BytecodeCompiler::compile(*balanced);
+
+        REQUIRE(program.max_stack_depth() == 4);
+        REQUIRE(program.run() == 21 + 165);
+    }
+}
+
+TEST_CASE("bytecode program gives the same results as the evaluator visitor", "[bytecode]")
+{
+    auto expr = multiply(add(integer(1), integer(2)), add(integer(3), multiply(integer(4), integer(5))));
+
+    ExprEvalVisitor visitor;
+    expr->accept(visitor);
+
+    auto program = BytecodeCompiler::compile(*expr);
+    std::vector<int> stack;
+
+    REQUIRE(program.run(stack) == visitor.result());
+    REQUIRE(program.run(stack) == 69);
+}
+
+TEST_CASE("bytecode compiler is used only through compile()", "[bytecode]")
+{
+    // a compiler visiting a tree before its subtrees are measured would index an empty table
+    static_assert(!std::is_default_constructible_v<BytecodeCompiler>);
+
+    auto expr = add(multiply(integer(2), integer(3)), integer(4));
+
+    auto first = BytecodeCompiler::compile(*expr);
+    auto second = BytecodeCompiler::compile(*expr);
+
+    REQUIRE(first.code() == second.code());
+    REQUIRE(first.constants() == second.constants());
+    REQUIRE(second.run() == 10);
+}
@@ -0,0 +1,7 @@
+#ifndef CATCH2_V2_CATCH_TEST_MACROS_HPP
+#define CATCH2_V2_CATCH_TEST_MACROS_HPP
+
+// Catch2 v2 provides the macros of the v3 header in the single catch.hpp
+#include <catch2/catch.hpp>
+
+#endif // CATCH2_V2_CATCH_TEST_MACROS_HPP
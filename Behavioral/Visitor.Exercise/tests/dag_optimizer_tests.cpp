@@ -0,0 +1,108 @@
+#include "ast.hpp"
+#include "bytecode.hpp"
+#include "dag_optimizer.hpp"
+#include "flat_ast.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <climits>
+#include <vector>
+
+using namespace AST;
+using namespace AST::helpers;
+
+TEST_CASE("dag optimizer", "[dag_optimizer]")
+{
+    SECTION("constant subtrees are folded")
+    {
+        auto expr = add(integer(3), multiply(integer(2), integer(5)));
+        auto dag = DagOptimizer::optimize(*expr);
+
+        REQUIRE(dag.size() == 1);
+        REQUIRE(dag.node(dag.root()).kind == FlatAst::NodeKind::integer);
+        REQUIRE(dag.evaluate() == 13);
+    }
+
+    SECTION("constant subtree next to a variable")
+    {
+        auto expr = multiply(variable(0), add(integer(2), integer(5)));
+        auto dag = DagOptimizer::optimize(*expr);
+        const std::vector<int> row = {3};
+
+        REQUIRE(dag.size() == 3);
+        REQUIRE(dag.evaluate(&row) == 21);
+    }
+
+    SECTION("identical subtrees are stored once")
+    {
+        auto expr = add(multiply(variable(0), integer(2)), multiply(variable(0), integer(2)));
+
+        DagOptimizer optimizer;
+        expr->accept(optimizer);
+        REQUIRE(optimizer.tree_size() == 7);
+
+        auto dag = optimizer.release();
+        const auto& root = dag.node(dag.root());
+
+        REQUIRE(dag.size() == 4);
+        REQUIRE(root.left == root.right);
+    }
+
+    SECTION("operands of commutative operations are shared in any order")
+    {
+        auto expr = multiply(add(variable(0), variable(1)), add(variable(1), variable(0)));
+        auto dag = DagOptimizer::optimize(*expr);
+        const std::vector<int> row = {2, 3};
+
+        REQUIRE(dag.size() == 4);
+        REQUIRE(dag.evaluate(&row) == 25);
+    }
+}
+
+TEST_CASE("constants are folded with the arithmetic of the evaluators", "[dag_optimizer]")
+{
+    const std::vector<int> row = {INT_MAX};
+    ExpressionNodePtr exprs[] = {
+        multiply(add(integer(INT_MAX), integer(1)), integer(3)),
+        multiply(integer(65536), integer(65536)),
+        add(integer(INT_MIN), integer(-1)),
+        add(variable(0), multiply(integer(INT_MAX), integer(INT_MAX)))};
+
+    for (auto& expr : exprs)
+    {
+        auto dag = DagOptimizer::optimize(*expr);
+
+        ExprEvalVisitor visitor{&row};
+        expr->accept(visitor);
+
+        REQUIRE(dag.evaluate(&row) == visitor.result());
+        REQUIRE(BytecodeCompiler::compile(*expr).run(&row) == visitor.result());
+    }
+
+    REQUIRE(DagOptimizer::optimize(*exprs[0]).evaluate() == INT_MIN);
+    REQUIRE(DagOptimizer::optimize(*exprs[1]).evaluate() == 0);
+    REQUIRE(DagOptimizer::optimize(*exprs[2]).evaluate() == INT_MAX);
+    REQUIRE(DagOptimizer::optimize(*exprs[3]).evaluate(&row) == INT_MIN);
+}
+
+TEST_CASE("optimized dag gives the same results as the evaluator visitor", "[dag_optimizer]")
+{
+    // ((x0 * 2 + 1 * x1) + (x0 * 2 + x1 * 1)) * ((1 + 2) * (x1 + x0))
+    auto expr = multiply(
+        add(add(multiply(variable(0), integer(2)), multiply(integer(1), variable(1))),
+            add(multiply(variable(0), integer(2)), multiply(variable(1), integer(1)))),
+        multiply(add(integer(1), integer(2)), add(variable(1), variable(0))));
+    auto dag = DagOptimizer::optimize(*expr);
+
+    for (int x0 = -3; x0 <= 3; ++x0)
+    {
+        for (int x1 = -3; x1 <= 3; ++x1)
+        {
+            const std::vector<int> row = {x0, x1};
+            ExprEvalVisitor visitor{&row};
+            expr->accept(visitor);
+
+            REQUIRE(dag.evaluate(&row) == visitor.result());
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include "ast.hpp"
+#include "flat_ast.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+using namespace AST;
+using namespace AST::helpers;
+
+TEST_CASE("flat ast", "[flat_ast]")
+{
+    FlatAst ast;
+
+    SECTION("children are stored before parents")
+    {
+        auto three = ast.integer(3);
+        auto two = ast.integer(2);
+        auto five = ast.integer(5);
+        auto product = ast.multiply(two, five);
+        auto sum = ast.add(three, product);
+
+        REQUIRE(ast.size() == 5);
+        REQUIRE(ast.root() == sum);
+        REQUIRE(ast.node(sum).kind == FlatAst::NodeKind::add);
+        REQUIRE(ast.node(sum).left == three);
+        REQUIRE(ast.node(sum).right == product);
+    }
+
+    SECTION("evaluate")
+    {
+        ast.add(ast.integer(3), ast.multiply(ast.integer(2), ast.integer(5)));
+
+        REQUIRE(ast.evaluate() == 13);
+    }
+
+    SECTION("copied from a tree built with helpers")
+    {
+        auto expr = add(integer(3), multiply(integer(2), integer(5)));
+
+        ast = FlatAst::from(*expr);
+
+        REQUIRE(ast.size() == 5);
+        REQUIRE(ast.evaluate() == 13);
+    }
+
+    SECTION("walked by an AST visitor")
+    {
+        auto expr = multiply(add(integer(1), integer(2)), add(integer(3), integer(4)));
+        ast = FlatAst::from(*expr);
+
+        ExprEvalVisitor visitor;
+        ast.accept(visitor);
+
+        REQUIRE(visitor.result() == 21);
+    }
+
+    SECTION("clear releases all nodes")
+    {
+        ast.add(ast.integer(1), ast.integer(2));
+        ast.clear();
+
+        REQUIRE(ast.empty());
+    }
+}
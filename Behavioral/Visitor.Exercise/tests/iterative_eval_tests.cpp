@@ -0,0 +1,149 @@
+#include "ast.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+
+using namespace AST;
+using namespace AST::helpers;
+
+namespace
+{
+    // left-leaning chain: ((((0 + 1) + 1) + 1) ...)
+    ExpressionNodePtr left_chain(size_t depth)
+    {
+        ExpressionNodePtr expr = integer(0);
+        for (size_t i = 0; i < depth; ++i)
+            expr = add(std::move(expr), integer(1));
+
+        return expr;
+    }
+
+    // right-leaning chain: (1 + (1 + (1 + ... 0)))
+    ExpressionNodePtr right_chain(size_t depth)
+    {
+        ExpressionNodePtr expr = integer(0);
+        for (size_t i = 0; i < depth; ++i)
+            expr = add(integer(1), std::move(expr));
+
+        return expr;
+    }
+
+    // deep path turning at every level: 1 + ((1 + (... * 1)) * 1)
+    ExpressionNodePtr zigzag(size_t depth)
+    {
+        ExpressionNodePtr expr = integer(0);
+        for (size_t i = 0; i < depth; ++i)
+            expr = (i % 2 == 0) ? ExpressionNodePtr{multiply(std::move(expr), integer(1))} : ExpressionNodePtr{add(integer(1), std::move(expr))};
+
+        return expr;
+    }
+
+    void require_iterative_evaluation_and_teardown(size_t depth)
+    {
+        auto expr = left_chain(depth);
+
+        SECTION("are evaluated iteratively")
+        {
+            IterativeEvalVisitor visitor;
+            expr->accept(visitor);
+
+            REQUIRE(visitor.result() == static_cast<int>(depth));
+        }
+
+        SECTION("are destroyed without recursion")
+        {
+            expr.reset();
+
+            REQUIRE(expr == nullptr);
+        }
+    }
+}
+
+TEST_CASE("iterative evaluator visitor", "[ast]")
+{
+    IterativeEvalVisitor visitor;
+
+    SECTION("integer")
+    {
+        auto expr = integer(4);
+        expr->accept(visitor);
+
+        REQUIRE(visitor.result() == 4);
+    }
+
+    SECTION("composite expression")
+    {
+        auto expr = add(integer(3), multiply(integer(2), integer(5)));
+        expr->accept(visitor);
+
+        REQUIRE(visitor.result() == 13);
+    }
+
+    SECTION("operands keep their order")
+    {
+        auto expr = multiply(add(integer(1), integer(2)), add(multiply(integer(3), integer(4)), integer(5)));
+        expr->accept(visitor);
+
+        ExprEvalVisitor recursive_visitor;
+        expr->accept(recursive_visitor);
+
+        REQUIRE(visitor.result() == 51);
+        REQUIRE(visitor.result() == recursive_visitor.result());
+    }
+
+    SECTION("visitor is reusable")
+    {
+        auto first = add(integer(1), integer(2));
+        auto second = multiply(integer(3), integer(4));
+
+        first->accept(visitor);
+        second->accept(visitor);
+
+        REQUIRE(visitor.result() == 12);
+    }
+}
+
+TEST_CASE("trees deeper than the thread stack", "[ast][deep]")
+{
+    constexpr size_t depth = 1'000'000; // a recursive walk would overflow a default 8 MB stack
+
+    require_iterative_evaluation_and_teardown(depth);
+}
+
+TEST_CASE("deep trees of any shape are destroyed without recursion", "[ast][deep]")
+{
+    constexpr size_t depth = 1'000'000;
+
+    SECTION("right-leaning chain")
+    {
+        auto expr = right_chain(depth);
+
+        IterativeEvalVisitor visitor;
+        expr->accept(visitor);
+        REQUIRE(visitor.result() == static_cast<int>(depth));
+
+        expr.reset();
+        REQUIRE(expr == nullptr);
+    }
+
+    SECTION("zigzag")
+    {
+        auto expr = zigzag(depth);
+
+        IterativeEvalVisitor visitor;
+        expr->accept(visitor);
+        REQUIRE(visitor.result() == static_cast<int>(depth / 2));
+
+        expr.reset();
+        REQUIRE(expr == nullptr);
+    }
+}
+
+// hidden - takes tens of seconds in a Debug build; run with the [.deep] tag
+TEST_CASE("trees of 10^7 nodes", "[ast][.deep]")
+{
+    constexpr size_t depth = 10'000'000;
+
+    require_iterative_evaluation_and_teardown(depth);
+}
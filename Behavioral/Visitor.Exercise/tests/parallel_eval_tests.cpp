@@ -0,0 +1,73 @@
+#include "ast.hpp"
+#include "parallel_eval.hpp"
+#include "thread_pool.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace AST;
+using namespace AST::helpers;
+
+namespace
+{
+    // leaves alternate between variables and small integers
+    ExpressionNodePtr balanced(size_t leaf_count, size_t first_leaf = 0)
+    {
+        if (leaf_count == 1)
+            return (first_leaf % 2 == 0) ? variable(first_leaf % 3) : integer(static_cast<int>(first_leaf % 5));
+
+        const size_t left_count = leaf_count / 2;
+        auto left = balanced(left_count, first_leaf);
+        auto right = balanced(leaf_count - left_count, first_leaf + left_count);
+
+        if (leaf_count < 8)
+            return multiply(std::move(left), std::move(right));
+
+        return add(std::move(left), std::move(right));
+    }
+
+    int evaluate(ExpressionNode& expr, const std::vector<int>* variables)
+    {
+        ExprEvalVisitor visitor{variables};
+        expr.accept(visitor);
+        return visitor.result();
+    }
+}
+
+TEST_CASE("parallel evaluator", "[parallel_eval]")
+{
+    const std::vector<int> row = {1, 2, 3};
+    auto expr = balanced(1000);
+
+    for (size_t thread_count : {1, 4})
+    {
+        WorkStealingPool pool{thread_count};
+
+        SECTION("gives the same results as the evaluator visitor - threads: " + std::to_string(thread_count))
+        {
+            ParallelEvaluator evaluator{pool, *expr, 16};
+
+            REQUIRE(evaluator.sequential_task_count() > 32);
+            REQUIRE(evaluator.evaluate(&row) == evaluate(*expr, &row));
+            REQUIRE(evaluator.evaluate(&row) == evaluate(*expr, &row));
+        }
+
+        SECTION("small tree is evaluated sequentially - threads: " + std::to_string(thread_count))
+        {
+            auto small = add(integer(3), multiply(integer(2), integer(5)));
+            ParallelEvaluator evaluator{pool, *small};
+
+            REQUIRE(evaluator.sequential_task_count() == 1);
+            REQUIRE(evaluator.evaluate() == 13);
+        }
+
+        SECTION("errors of forked tasks are rethrown - threads: " + std::to_string(thread_count))
+        {
+            ParallelEvaluator evaluator{pool, *expr, 16};
+
+            REQUIRE_THROWS_AS(evaluator.evaluate(), std::out_of_range);
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#include "ast.hpp"
+#include "flat_ast.hpp"
+#include "parser.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <climits>
+#include <string>
+#include <vector>
+
+using namespace AST;
+
+namespace
+{
+    int evaluate(ExpressionNode& expr, const std::vector<int>* variables = nullptr)
+    {
+        ExprEvalVisitor visitor{variables};
+        expr.accept(visitor);
+        return visitor.result();
+    }
+
+    size_t error_offset(Parser& parser, const std::string& text)
+    {
+        try
+        {
+            parser.parse(text);
+        }
+        catch (const ParseError& e)
+        {
+            return e.offset();
+        }
+
+        FAIL("No ParseError for: " << text);
+        return 0;
+    }
+}
+
+TEST_CASE("parser", "[parser]")
+{
+    Parser parser;
+
+    SECTION("integer")
+    {
+        REQUIRE(evaluate(*parser.parse("42")) == 42);
+    }
+
+    SECTION("negative integers")
+    {
+        REQUIRE(evaluate(*parser.parse("-42")) == -42);
+        REQUIRE(evaluate(*parser.parse("3 * -2 + -1")) == -7);
+        REQUIRE(evaluate(*parser.parse("(-1)*-2")) == 2);
+        REQUIRE(evaluate(*parser.parse("-2147483648")) == INT_MIN);
+        REQUIRE(evaluate(*parser.parse("2147483647")) == INT_MAX);
+    }
+
+    SECTION("multiplication binds stronger than addition")
+    {
+        REQUIRE(evaluate(*parser.parse("3 + 2 * 5")) == 13);
+        REQUIRE(evaluate(*parser.parse("2 * 5 + 3")) == 13);
+    }
+
+    SECTION("parentheses")
+    {
+        REQUIRE(evaluate(*parser.parse("(3 + 2) * 5")) == 25);
+        REQUIRE(evaluate(*parser.parse("((((7))))")) == 7);
+    }
+
+    SECTION("operators are left-associative")
+    {
+        auto expr = parser.parse("1 + 2 + 3");
+        auto& root = dynamic_cast<AddNode&>(*expr);
+
+        REQUIRE(dynamic_cast<AddNode*>(&root.left()) != nullptr);
+        REQUIRE(dynamic_cast<IntNode&>(root.right()).value() == 3);
+    }
+
+    SECTION("whitespace is optional")
+    {
+        REQUIRE(evaluate(*parser.parse("\t(1+2)*\n3 ")) == 9);
+    }
+
+    SECTION("variables")
+    {
+        const std::vector<int> row = {2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 10};
+        REQUIRE(evaluate(*parser.parse("x0 * (x11 + 1)"), &row) == 22);
+    }
+
+    SECTION("parser is reusable")
+    {
+        REQUIRE(evaluate(*parser.parse("1 + 1")) == 2);
+        REQUIRE(evaluate(*parser.parse("2 * 2")) == 4);
+    }
+
+    SECTION("arena form")
+    {
+        FlatAst ast;
+        const auto root = parser.parse("3 + 2 * 5", ast);
+
+        REQUIRE(ast.size() == 5);
+        REQUIRE(root == ast.root());
+        REQUIRE(ast.evaluate() == 13);
+    }
+
+    SECTION("very deep nesting")
+    {
+        const size_t depth = 100'000;
+        const std::string text = std::string(depth, '(') + "1" + std::string(depth, ')') + " + 2";
+
+        REQUIRE(evaluate(*parser.parse(text)) == 3);
+    }
+}
+
+TEST_CASE("parse errors are reported by offset", "[parser]")
+{
+    Parser parser;
+
+    REQUIRE(error_offset(parser, "") == 0);
+    REQUIRE(error_offset(parser, "1 +") == 3);
+    REQUIRE(error_offset(parser, "1 + * 2") == 4);
+    REQUIRE(error_offset(parser, "1 2") == 2);
+    REQUIRE(error_offset(parser, "(1 + 2") == 0);
+    REQUIRE(error_offset(parser, "1 + 2)") == 5);
+    REQUIRE(error_offset(parser, "1 - 2") == 2);
+    REQUIRE(error_offset(parser, "x + 1") == 1);
+    REQUIRE(error_offset(parser, "1 + 99999999999") == 4);
+    REQUIRE(error_offset(parser, "1 + -2147483649") == 4);
+    REQUIRE(error_offset(parser, "1 + - 2") == 4);
+    REQUIRE(error_offset(parser, "1 -2") == 2);
+
+    REQUIRE_THROWS_WITH(parser.parse("1 +"), "Expected an integer, a variable or '(' at offset 3");
+}
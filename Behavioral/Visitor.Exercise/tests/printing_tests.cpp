@@ -0,0 +1,173 @@
+#include "ast.hpp"
+#include "parser.hpp"
+#include "visitors.hpp"
+#include <catch2/catch_test_macros.hpp>
+
+#include <climits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace AST;
+using namespace AST::helpers;
+
+namespace
+{
+    std::string print(ExpressionNode& expr, PrintingVisitor::Parentheses parentheses)
+    {
+        PrintingVisitor visitor{parentheses};
+        expr.accept(visitor);
+        return visitor.str();
+    }
+
+    std::string print_minimal(ExpressionNode& expr)
+    {
+        return print(expr, PrintingVisitor::Parentheses::minimal);
+    }
+
+    ExpressionNodePtr chain(size_t length)
+    {
+        ExpressionNodePtr expr = integer(1);
+        for (size_t i = 0; i < length; ++i)
+        {
+            if (i % 2 == 0)
+                expr = add(std::move(expr), variable(i % 3));
+            else
+                expr = multiply(std::move(expr), integer(2));
+        }
+
+        return expr;
+    }
+}
+
+TEST_CASE("printing visitor - minimal parentheses", "[printing]")
+{
+    SECTION("leaves")
+    {
+        REQUIRE(print_minimal(*integer(-42)) == "-42");
+        REQUIRE(print_minimal(*variable(7)) == "x7");
+    }
+
+    SECTION("precedence")
+    {
+        REQUIRE(print_minimal(*add(integer(3), multiply(integer(2), integer(5)))) == "3 + 2 * 5");
+        REQUIRE(print_minimal(*multiply(add(integer(1), integer(2)), integer(3))) == "(1 + 2) * 3");
+        REQUIRE(print_minimal(*multiply(integer(3), add(integer(1), variable(0)))) == "3 * (1 + x0)");
+    }
+
+    SECTION("associativity")
+    {
+        REQUIRE(print_minimal(*add(add(integer(1), integer(2)), integer(3))) == "1 + 2 + 3");
+        REQUIRE(print_minimal(*add(integer(1), add(integer(2), integer(3)))) == "1 + (2 + 3)");
+        REQUIRE(print_minimal(*multiply(integer(1), multiply(integer(2), integer(3)))) == "1 * (2 * 3)");
+    }
+
+    SECTION("text is parsed to the same tree")
+    {
+        Parser parser;
+        const char* formulas[] = {"x0", "1 + 2 * x1", "(1 + 2) * (x0 + 4)", "1 + (2 + (3 + 4))", "2 * (x0 * (1 + 2 * (3 + x1)))"};
+
+        for (const char* formula : formulas)
+        {
+            auto expr = parser.parse(formula);
+            const std::string minimal = print_minimal(*expr);
+            const std::string full = print(*expr, PrintingVisitor::Parentheses::full);
+
+            REQUIRE(print_minimal(*parser.parse(minimal)) == minimal);
+            REQUIRE(print_minimal(*parser.parse(full)) == minimal);
+        }
+    }
+
+    SECTION("negative integers are parsed back")
+    {
+        Parser parser;
+        ExpressionNodePtr exprs[] = {
+            integer(INT_MIN),
+            add(integer(1), integer(-2)),
+            multiply(integer(-3), add(integer(INT_MIN), variable(0))),
+            add(multiply(integer(INT_MAX), integer(-1)), multiply(integer(-7), integer(INT_MIN)))};
+
+        for (auto& expr : exprs)
+        {
+            const std::string minimal = print_minimal(*expr);
+            const std::string full = print(*expr, PrintingVisitor::Parentheses::full);
+
+            REQUIRE(print_minimal(*parser.parse(minimal)) == minimal);
+            REQUIRE(print_minimal(*parser.parse(full)) == minimal);
+        }
+
+        REQUIRE(print_minimal(*exprs[2]) == "-3 * (-2147483648 + x0)");
+        REQUIRE(dynamic_cast<IntNode&>(*parser.parse(print_minimal(*exprs[0]))).value() == INT_MIN);
+    }
+}
+
+TEST_CASE("printing visitor - buffer and stream", "[printing]")
+{
+    auto expr = add(integer(3), multiply(integer(2), integer(5)));
+
+    SECTION("subsequent prints are appended until clear()")
+    {
+        PrintingVisitor visitor;
+        expr->accept(visitor);
+        expr->accept(visitor);
+        REQUIRE(visitor.str() == "(3 + (2 * 5))(3 + (2 * 5))");
+
+        visitor.clear();
+        expr->accept(visitor);
+        REQUIRE(visitor.str() == "(3 + (2 * 5))");
+    }
+
+    SECTION("text is written to the stream in chunks")
+    {
+        auto long_expr = chain(1000);
+        const std::string expected = print_minimal(*long_expr);
+
+        std::ostringstream out;
+        {
+            PrintingVisitor visitor{PrintingVisitor::Parentheses::minimal, &out, 64};
+            long_expr->accept(visitor);
+
+            REQUIRE(visitor.str().size() < 64);
+            REQUIRE(out.str() + visitor.str() == expected);
+        }
+
+        REQUIRE(out.str() == expected);
+    }
+}
+
+TEST_CASE("printing visitor - deep trees", "[printing]")
+{
+    const size_t depth = 3 * PrintingVisitor::max_recursion_depth + 1;
+    auto expr = chain(depth);
+
+    SECTION("right operands")
+    {
+        ExpressionNodePtr right_chain = integer(0);
+        std::string expected = "0";
+        for (int i = 1; i <= 300; ++i)
+        {
+            right_chain = add(integer(i), multiply(integer(2), std::move(right_chain)));
+            expected = std::to_string(i) + " + 2 * " + (i == 1 ? expected : "(" + expected + ")");
+        }
+
+        REQUIRE(print_minimal(*right_chain) == expected);
+    }
+
+    SECTION("text is parsed to the same tree")
+    {
+        const std::string minimal = print_minimal(*expr);
+        const std::string full = print(*expr, PrintingVisitor::Parentheses::full);
+
+        Parser parser;
+        REQUIRE(print_minimal(*parser.parse(full)) == minimal);
+        REQUIRE(print(*parser.parse(minimal), PrintingVisitor::Parentheses::full) == full);
+
+        const std::vector<int> variables{1, 2, 3};
+        ExprEvalVisitor evaluator{&variables};
+        parser.parse(minimal)->accept(evaluator);
+        IterativeEvalVisitor expected{&variables};
+        expr->accept(expected);
+        REQUIRE(evaluator.result() == expected.result());
+    }
+}
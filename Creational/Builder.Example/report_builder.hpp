@@ -1,6 +1,7 @@
 #ifndef RAPORT_BUILDER_HPP
 #define RAPORT_BUILDER_HPP
 
+#include <iterator>
 #include <memory>
 #include <string>
 #include <vector>